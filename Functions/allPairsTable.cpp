@@ -0,0 +1,148 @@
+/**
+ * @file allPairsTable.cpp
+ * @brief Implements the precomputed all-pairs table and its cache file.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <unordered_set>
+#include "../include/AllPairsTable.h"
+#include "../include/CreatingMap.h"
+#include "../include/Landmarks.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "../include/WorkStealingScheduler.h"
+
+static const char ALL_PAIRS_MAGIC[8] = {'M', 'G', 'P', 'S', 'A', 'P', 'T', '1'};
+
+// The arrays start on a cache line boundary after the header: magic, fingerprint, vertex count, padding
+#define ALL_PAIRS_HEADER_SIZE 64
+
+/**
+ * @brief Runs one Dijkstra search per source and metric, spread over a work-stealing pool.
+ *
+ * Task i computes row i / 2 of metric i % 2, so both metrics advance together. Each row is the search tree of
+ * a full search, whose paths are the ones dijkstraToTarget stops at.
+ */
+bool AllPairsTable::build(const LoadedMap& map, SearchWorkspace& ws, unsigned threads) {
+    const CsrGraph<Location>& csr = map.csr;
+    unsigned n = csr.getNumVertex();
+    numVertex = 0;
+    if (n > ALL_PAIRS_MAX_VERTICES) return false;
+
+    size_t cells = static_cast<size_t>(n) * n;
+    std::vector<double> distances[2];
+    std::vector<unsigned> lastEdges[2];
+    for (int m = 0; m < 2; m++) {
+        distances[m].assign(cells, INF);
+        lastEdges[m].assign(cells, NO_EDGE);
+    }
+
+    static const std::unordered_set<int> noIgnore;
+    WorkStealingScheduler scheduler(static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, 2 * n))));
+    std::vector<std::unique_ptr<SearchWorkspace>> workspaces(scheduler.getNumWorkers());
+    scheduler.run(2 * n, [&](unsigned worker, size_t i) {
+        if (worker > 0 && !workspaces[worker]) workspaces[worker].reset(new SearchWorkspace(map));
+        SearchWorkspace& workspace = worker == 0 ? ws : *workspaces[worker];
+        bool driving = i % 2;
+        unsigned s = static_cast<unsigned>(i / 2);
+        workspace.reset();
+        dijkstra(map, workspace, workspace.forward, map.idOf(s), driving, false, noIgnore);
+        double* row = distances[driving].data() + static_cast<size_t>(s) * n;
+        unsigned* rowLast = lastEdges[driving].data() + static_cast<size_t>(s) * n;
+        for (int v : workspace.forward.getTouched()) {
+            row[v] = workspace.forward.getDist(v);
+            rowLast[v] = workspace.forward.getPath(v);
+        }
+    });
+
+    for (int m = 0; m < 2; m++) {
+        dist[m].assign(std::move(distances[m]));
+        last[m].assign(std::move(lastEdges[m]));
+    }
+    file.close();
+    numVertex = n;
+    return true;
+}
+
+/**
+ * @brief Writes the table to a binary file.
+ *
+ * Layout: a header of ALL_PAIRS_HEADER_SIZE bytes (magic, fingerprint, vertex count), then for each metric
+ * the travel times and the last edges, so every array is aligned for its element type.
+ */
+bool AllPairsTable::save(const std::string& path, const CsrGraph<Location>& csr) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char header[ALL_PAIRS_HEADER_SIZE] = {};
+    unsigned long long fingerprint = graphFingerprint(csr);
+    std::memcpy(header, ALL_PAIRS_MAGIC, sizeof(ALL_PAIRS_MAGIC));
+    std::memcpy(header + 8, &fingerprint, sizeof(fingerprint));
+    std::memcpy(header + 16, &numVertex, sizeof(numVertex));
+    file.write(header, sizeof(header));
+
+    size_t cells = static_cast<size_t>(numVertex) * numVertex;
+    for (int m = 0; m < 2; m++) {
+        file.write(reinterpret_cast<const char*>(dist[m].data()), cells * sizeof(double));
+        file.write(reinterpret_cast<const char*>(last[m].data()), cells * sizeof(unsigned));
+    }
+    return file.good();
+}
+
+/**
+ * @brief Maps the table file and points the arrays into it, rejecting files written for another graph.
+ */
+bool AllPairsTable::load(const std::string& path, const CsrGraph<Location>& csr) {
+    MappedFile mapped;
+    if (!mapped.open(path, false) || mapped.size() < ALL_PAIRS_HEADER_SIZE) return false;
+
+    unsigned long long fingerprint;
+    unsigned n;
+    std::memcpy(&fingerprint, mapped.begin() + 8, sizeof(fingerprint));
+    std::memcpy(&n, mapped.begin() + 16, sizeof(n));
+    size_t cells = static_cast<size_t>(n) * n;
+    if (std::memcmp(mapped.begin(), ALL_PAIRS_MAGIC, sizeof(ALL_PAIRS_MAGIC)) != 0 || n != csr.getNumVertex() ||
+        mapped.size() != ALL_PAIRS_HEADER_SIZE + 2 * cells * (sizeof(double) + sizeof(unsigned)) ||
+        fingerprint != graphFingerprint(csr)) {
+        return false;
+    }
+
+    const char* p = mapped.begin() + ALL_PAIRS_HEADER_SIZE;
+    for (int m = 0; m < 2; m++) {
+        dist[m].attach(reinterpret_cast<const double*>(p), cells);
+        p += cells * sizeof(double);
+        last[m].attach(reinterpret_cast<const unsigned*>(p), cells);
+        p += cells * sizeof(unsigned);
+    }
+    file = std::move(mapped);
+    numVertex = n;
+    return true;
+}
+
+/**
+ * @brief Follows the last edges of row s back from t, then reverses them into path order.
+ */
+void AllPairsTable::path(bool driving, unsigned s, unsigned t, const CsrGraph<Location>& csr, std::vector<unsigned>& edges) const {
+    size_t first = edges.size();
+    const unsigned* row = last[driving].data() + static_cast<size_t>(s) * numVertex;
+    for (unsigned e; (e = row[t]) != NO_EDGE; t = csr.getSource(e)) edges.push_back(e);
+    std::reverse(edges.begin() + first, edges.end());
+}
+
+void prepareAllPairsTable(LoadedMap& map, SearchWorkspace& ws, const std::string& path, unsigned threads) {
+    if (map.allPairs.load(path, map.csr)) return;
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (!map.allPairs.build(map, ws, threads)) {
+        std::cerr << "All-pairs table not built: the map has more than " << ALL_PAIRS_MAX_VERTICES << " locations" << std::endl;
+        return;
+    }
+    if (!map.allPairs.save(path, map.csr)) {
+        std::cerr << "Warning: could not write " << path << std::endl;
+    }
+}
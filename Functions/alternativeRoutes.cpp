@@ -0,0 +1,105 @@
+/**
+ * @file alternativeRoutes.cpp
+ * @brief Implements the plateau-based alternative routes.
+ */
+
+#include <algorithm>
+#include <unordered_set>
+#include "../include/AlternativeRoutes.h"
+#include "../include/RoutePlanningUtils.h"
+
+/**
+ * @brief Computes the shortest route and an alternative with one forward and one backward search.
+ *
+ * A plateau starts at a vertex whose backward tree edge is on both trees and whose forward tree edge is not,
+ * so each plateau is walked once. The backward search only expands the vertices whose distances from the origin
+ * and to the destination add up to at most the stretched distance. Those are the only via vertices of interest,
+ * and they are settled in both searches, so their distances and tree edges are exact.
+ * With the all-pairs table, the forward tree is copied from the table instead of searched.
+ */
+AlternativeRoute findAlternativeRoute(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, bool driving,
+                                      const std::vector<unsigned>* shortest) {
+    static const std::unordered_set<int> noIgnore;
+    const CsrGraph<Location>& csr = map.csr;
+    SearchTree& fwd = ws.forward;
+    SearchTree& bwd = ws.backward;
+    AlternativeRoute result;
+
+    ws.reset();
+    unsigned s = map.indexOf(origin), t = map.indexOf(destination);
+    const AllPairsTable& table = map.allPairs;
+    double d;
+    if (table.empty()) {
+        dijkstraWithinStretch(map, ws, fwd, origin, destination, ALTERNATIVE_MAX_STRETCH, driving, noIgnore);
+        d = fwd.getDist(t);
+    } else {
+        // Row s of the table is the tree of a full search from s: copy the part the stretched search would settle
+        d = table.getDist(driving, s, t);
+        fwd.reset();
+        for (unsigned v = 0; d != INF && v < csr.getNumVertex(); v++) {
+            double dv = table.getDist(driving, s, v);
+            if (dv > d * (1 + ALTERNATIVE_MAX_STRETCH)) continue;
+            SearchTree::Node& node = fwd.touch(v);
+            node.dist = dv;
+            node.path = table.getLastEdge(driving, s, v);
+        }
+    }
+    if (d == INF) return result;
+
+    result.found = true;
+    if (shortest != nullptr) {
+        result.shortest = *shortest;
+    } else {
+        for (unsigned v = t, e; (e = fwd.getPath(v)) != NO_EDGE; v = csr.getSource(e)) result.shortest.push_back(e);
+        std::reverse(result.shortest.begin(), result.shortest.end());
+    }
+    if (d == 0) return result;
+
+    double maxDist = d * (1 + ALTERNATIVE_MAX_STRETCH);
+    reverseDijkstraWithin(map, ws, bwd, destination, maxDist, driving, noIgnore, &fwd);
+
+    std::vector<unsigned> onShortest(result.shortest);
+    std::sort(onShortest.begin(), onShortest.end());
+    auto weight = [&csr, driving](unsigned e) { return driving ? csr.getDriving(e) : csr.getWalking(e); };
+    auto onBothTrees = [&](unsigned e) {
+        return e != NO_EDGE && fwd.getPath(csr.getTarget(e)) == e && bwd.getPath(csr.getSource(e)) == e;
+    };
+
+    double bestScore = INF;
+    int bestVia = -1;
+    for (int x : fwd.getTouched()) {
+        double length = fwd.getDist(x) + bwd.getDist(x);
+        if (length > maxDist || !onBothTrees(bwd.getPath(x)) || onBothTrees(fwd.getPath(x))) continue;
+
+        unsigned z = x;
+        while (onBothTrees(bwd.getPath(z))) z = csr.getTarget(bwd.getPath(z));
+        double plateau = fwd.getDist(z) - fwd.getDist(x);
+        if (plateau < ALTERNATIVE_MIN_PLATEAU * d) continue;
+
+        // The route is the forward tree path to x, then the backward tree path from x, plateau included
+        double sharing = 0;
+        for (unsigned v = x, e; (e = fwd.getPath(v)) != NO_EDGE; v = csr.getSource(e)) {
+            if (std::binary_search(onShortest.begin(), onShortest.end(), e)) sharing += weight(e);
+        }
+        for (unsigned v = x, e; (e = bwd.getPath(v)) != NO_EDGE; v = csr.getTarget(e)) {
+            if (std::binary_search(onShortest.begin(), onShortest.end(), e)) sharing += weight(e);
+        }
+        if (sharing > ALTERNATIVE_MAX_SHARING * d) continue;
+
+        double score = 2 * length + sharing - plateau;
+        if (score < bestScore || (score == bestScore && x < bestVia)) {   // ties do not depend on the search order
+            bestScore = score;
+            bestVia = x;
+            result.alternativeDist = length;
+            result.sharing = sharing;
+            result.plateau = plateau;
+        }
+    }
+    if (bestVia == -1) return result;
+
+    result.foundAlternative = true;
+    for (unsigned v = bestVia, e; (e = fwd.getPath(v)) != NO_EDGE; v = csr.getSource(e)) result.alternative.push_back(e);
+    std::reverse(result.alternative.begin(), result.alternative.end());
+    for (unsigned v = bestVia, e; (e = bwd.getPath(v)) != NO_EDGE; v = csr.getTarget(e)) result.alternative.push_back(e);
+    return result;
+}
@@ -0,0 +1,351 @@
+/**
+ * @file ContractionHierarchy.cpp
+ * @brief Implements the Contraction Hierarchies preprocessing and query.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include "../include/ContractionHierarchy.h"
+#include "../include/CreatingMap.h"
+#include "../include/SearchWorkspace.h"
+
+/** Maximum number of vertices settled by one witness search; beyond it a shortcut is added anyway. */
+#define WITNESS_SETTLE_LIMIT 200
+
+namespace {
+
+/**
+ * @brief Mutable state of the contraction: the remaining graph and the witness search buffers.
+ */
+struct Contractor {
+    struct Arc {
+        unsigned from, to;
+        double weight;
+        unsigned edge, first, second;
+    };
+
+    std::vector<Arc> arcs;
+    std::vector<std::vector<unsigned>> out, in;     // arcs between vertices not contracted yet
+    std::vector<bool> contracted;
+
+    std::vector<double> dist;                       // witness search distances, valid when stamp == epoch
+    std::vector<unsigned> stamp;
+    unsigned epoch = 0;
+    std::vector<std::pair<double, unsigned>> heap;  // witness search queue, kept to reuse its capacity
+
+    explicit Contractor(unsigned n): out(n), in(n), contracted(n, false), dist(n, INF), stamp(n, 0) {}
+
+    /**
+     * @brief Adds an arc, or lowers the weight of the existing arc between the same vertices.
+     */
+    void addArc(unsigned from, unsigned to, double weight, unsigned edge, unsigned first, unsigned second) {
+        for (unsigned& id : out[from]) {
+            if (arcs[id].to != to) continue;
+            if (arcs[id].weight <= weight) return;
+            unsigned old = id;
+            id = arcs.size();
+            std::replace(in[to].begin(), in[to].end(), old, id);
+            arcs.push_back({from, to, weight, edge, first, second});
+            return;
+        }
+        out[from].push_back(arcs.size());
+        in[to].push_back(arcs.size());
+        arcs.push_back({from, to, weight, edge, first, second});
+    }
+
+    /**
+     * @brief Distances from a source in the remaining graph without a given vertex, up to a bound.
+     */
+    void witnessSearch(unsigned source, unsigned avoid, double maxDist) {
+        typedef std::pair<double, unsigned> Entry;
+        std::greater<Entry> later;
+        epoch++;
+        heap.clear();
+        dist[source] = 0;
+        stamp[source] = epoch;
+        heap.push_back({0, source});
+        int settled = 0;
+        while (!heap.empty() && settled < WITNESS_SETTLE_LIMIT) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            Entry top = heap.back();
+            heap.pop_back();
+            unsigned v = top.second;
+            if (top.first > dist[v]) continue;
+            if (top.first > maxDist) break;
+            settled++;
+            for (unsigned id : out[v]) {
+                unsigned w = arcs[id].to;
+                if (w == avoid) continue;
+                double d = top.first + arcs[id].weight;
+                if (stamp[w] != epoch || d < dist[w]) {
+                    dist[w] = d;
+                    stamp[w] = epoch;
+                    heap.push_back({d, w});
+                    std::push_heap(heap.begin(), heap.end(), later);
+                }
+            }
+        }
+    }
+
+    double witnessDist(unsigned v) const {
+        return stamp[v] == epoch ? dist[v] : INF;
+    }
+
+    /**
+     * @brief Calls add(a, b) for every shortcut u -> v -> w needed when v is contracted, a and b being the arcs u -> v and v -> w.
+     */
+    template <class Add>
+    void forEachShortcut(unsigned v, Add add) {
+        double maxOut = 0;
+        for (unsigned b : out[v]) maxOut = std::max(maxOut, arcs[b].weight);
+        for (unsigned a : in[v]) {
+            unsigned u = arcs[a].from;
+            witnessSearch(u, v, arcs[a].weight + maxOut);
+            for (unsigned b : out[v]) {
+                unsigned w = arcs[b].to;
+                if (w == u) continue;
+                if (witnessDist(w) > arcs[a].weight + arcs[b].weight) add(a, b);
+            }
+        }
+    }
+
+    /**
+     * @brief Contraction priority of a vertex: twice the edge difference plus the contracted neighbours.
+     *
+     * @param shortcuts Receives the shortcuts that contracting v would need, as pairs of arcs.
+     */
+    int priority(unsigned v, const std::vector<int>& contractedNeighbours, std::vector<std::pair<unsigned, unsigned>>& shortcuts) {
+        shortcuts.clear();
+        forEachShortcut(v, [&shortcuts](unsigned a, unsigned b) { shortcuts.push_back({a, b}); });
+        int edgeDifference = static_cast<int>(shortcuts.size()) - static_cast<int>(in[v].size() + out[v].size());
+        return 2 * edgeDifference + contractedNeighbours[v];
+    }
+};
+
+}
+
+/**
+ * @brief Builds the hierarchy: contracts the vertices in order of priority and stores the upward and downward arcs.
+ *
+ * Priorities are updated lazily: the popped vertex is re-evaluated and put back if it is no longer the cheapest;
+ * otherwise the shortcuts found while re-evaluating it are inserted.
+ *
+ * @param csr CSR snapshot of the graph.
+ * @param useDriving True to use driving times; false to use walking times.
+ */
+void ContractionHierarchy::build(const CsrGraph<Location>& csr, bool useDriving) {
+    driving = useDriving;
+    unsigned n = csr.getNumVertex();
+    Contractor c(n);
+
+    for (unsigned e = 0; e < csr.getNumEdges(); e++) {
+        if (csr.getDriving(e) == INF) continue;
+        double cost = driving ? csr.getDriving(e) : csr.getWalking(e);
+        if (cost == INF || csr.getSource(e) == csr.getTarget(e)) continue;
+        c.addArc(csr.getSource(e), csr.getTarget(e), cost, e, NO_EDGE, NO_EDGE);
+    }
+
+    std::vector<int> contractedNeighbours(n, 0);
+    std::vector<std::pair<unsigned, unsigned>> shortcuts;
+    typedef std::pair<int, unsigned> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> order;
+    for (unsigned v = 0; v < n; v++) order.push({c.priority(v, contractedNeighbours, shortcuts), v});
+
+    rank.assign(n, 0);
+    std::vector<std::vector<unsigned>> up(n), down(n);
+    unsigned next = 0;
+    while (!order.empty()) {
+        unsigned v = order.top().second;
+        order.pop();
+        if (c.contracted[v]) continue;
+        int p = c.priority(v, contractedNeighbours, shortcuts);
+        if (!order.empty() && p > order.top().first) {
+            order.push({p, v});
+            continue;
+        }
+
+        for (auto& s : shortcuts) {
+            unsigned from = c.arcs[s.first].from;
+            unsigned to = c.arcs[s.second].to;
+            double weight = c.arcs[s.first].weight + c.arcs[s.second].weight;
+            c.addArc(from, to, weight, NO_EDGE, s.first, s.second);
+        }
+
+        // The remaining arcs of v all lead to vertices of higher rank
+        rank[v] = next++;
+        c.contracted[v] = true;
+        up[v] = c.out[v];
+        down[v] = c.in[v];
+        for (unsigned a : c.in[v]) {
+            unsigned u = c.arcs[a].from;
+            c.out[u].erase(std::find(c.out[u].begin(), c.out[u].end(), a));
+            contractedNeighbours[u]++;
+        }
+        for (unsigned b : c.out[v]) {
+            unsigned w = c.arcs[b].to;
+            c.in[w].erase(std::find(c.in[w].begin(), c.in[w].end(), b));
+            contractedNeighbours[w]++;
+        }
+        std::vector<unsigned>().swap(c.out[v]);
+        std::vector<unsigned>().swap(c.in[v]);
+    }
+
+    arcs.clear();
+    arcs.reserve(c.arcs.size());
+    for (const Contractor::Arc& a : c.arcs) arcs.push_back({a.from, a.to, a.weight, a.edge, a.first, a.second});
+    numShortcuts = 0;
+    for (const Arc& a : arcs) numShortcuts += a.edge == NO_EDGE;
+
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    upArcs.clear();
+    downArcs.clear();
+    for (unsigned v = 0; v < n; v++) {
+        upArcs.insert(upArcs.end(), up[v].begin(), up[v].end());
+        downArcs.insert(downArcs.end(), down[v].begin(), down[v].end());
+        upOffsets[v + 1] = upArcs.size();
+        downOffsets[v + 1] = downArcs.size();
+    }
+}
+
+/**
+ * @brief Appends the original CSR edges represented by an arc, in path order.
+ *
+ * @param arc Arc to unpack.
+ * @param edges Receives the CSR edge indices.
+ */
+void ContractionHierarchy::unpack(unsigned arc, std::vector<unsigned>& edges) const {
+    const Arc& a = arcs[arc];
+    if (a.edge != NO_EDGE) {
+        edges.push_back(a.edge);
+        return;
+    }
+    unpack(a.first, edges);
+    unpack(a.second, edges);
+}
+
+/**
+ * @brief Bidirectional upward search: the forward side follows arcs to higher ranks from s, the backward side
+ * follows them in reverse from t. A side stops when its smallest key can no longer improve the best meeting point.
+ *
+ * @param ws Workspace whose search trees are used.
+ * @param s Dense index of the origin.
+ * @param t Dense index of the destination.
+ * @param edges Receives the CSR indices of the edges of the path.
+ * @return Length of the path, or INF.
+ */
+double ContractionHierarchy::query(SearchWorkspace& ws, unsigned s, unsigned t, std::vector<unsigned>& edges) const {
+    edges.clear();
+    SearchTree& fwd = ws.forward;
+    SearchTree& bwd = ws.backward;
+    fwd.reset();
+    bwd.reset();
+
+    SearchTree::Node& sNode = fwd.touch(s);
+    sNode.dist = sNode.key = 0;
+    SearchTree::Node& tNode = bwd.touch(t);
+    tNode.dist = tNode.key = 0;
+    fwd.queue.insert(&sNode);
+    bwd.queue.insert(&tNode);
+
+    double best = INF;
+    unsigned meet = NO_EDGE;
+    while (true) {
+        bool fwdActive = !fwd.queue.empty() && fwd.queue.top()->key < best;
+        bool bwdActive = !bwd.queue.empty() && bwd.queue.top()->key < best;
+        if (!fwdActive && !bwdActive) break;
+        bool forward = fwdActive && (!bwdActive || fwd.queue.top()->key <= bwd.queue.top()->key);
+
+        SearchTree& tree = forward ? fwd : bwd;
+        SearchTree& other = forward ? bwd : fwd;
+        unsigned v = tree.indexOf(tree.queue.extractMin());
+        double dv = tree.getDist(v);
+        if (dv + other.getDist(v) < best) {
+            best = dv + other.getDist(v);
+            meet = v;
+        }
+
+        const std::vector<unsigned>& offsets = forward ? upOffsets : downOffsets;
+        const std::vector<unsigned>& list = forward ? upArcs : downArcs;
+        for (unsigned i = offsets[v]; i < offsets[v + 1]; i++) {
+            const Arc& a = arcs[list[i]];
+            unsigned w = forward ? a.to : a.from;
+            double d = dv + a.weight;
+            if (d < tree.getDist(w)) {
+                bool queued = tree.getDist(w) != INF;
+                SearchTree::Node& node = tree.touch(w);
+                node.dist = node.key = d;
+                node.path = list[i];
+                if (queued) tree.queue.decreaseKey(&node);
+                else tree.queue.insert(&node);
+            }
+        }
+    }
+    if (meet == NO_EDGE) return INF;
+
+    // s -> meet, collected backwards, then meet -> t
+    std::vector<unsigned> upPath;
+    for (unsigned x = meet; fwd.getPath(x) != NO_EDGE; x = arcs[fwd.getPath(x)].from) upPath.push_back(fwd.getPath(x));
+    for (auto it = upPath.rbegin(); it != upPath.rend(); ++it) unpack(*it, edges);
+    for (unsigned x = meet; bwd.getPath(x) != NO_EDGE; x = arcs[bwd.getPath(x)].to) unpack(bwd.getPath(x), edges);
+    return best;
+}
+
+/**
+ * @brief Settles the whole upward search space of a vertex, without the stopping criterion of a point-to-point query.
+ *
+ * @param tree Search tree receiving the distances.
+ * @param v Dense index of the start vertex.
+ * @param forward True to follow upward arcs out of v; false to follow them backwards, into v.
+ */
+void ContractionHierarchy::upwardSearch(SearchTree& tree, unsigned v, bool forward) const {
+    tree.reset();
+    SearchTree::Node& start = tree.touch(v);
+    start.dist = start.key = 0;
+    tree.queue.insert(&start);
+
+    const std::vector<unsigned>& offsets = forward ? upOffsets : downOffsets;
+    const std::vector<unsigned>& list = forward ? upArcs : downArcs;
+    while (!tree.queue.empty()) {
+        unsigned u = tree.indexOf(tree.queue.extractMin());
+        double du = tree.getDist(u);
+        for (unsigned i = offsets[u]; i < offsets[u + 1]; i++) {
+            const Arc& a = arcs[list[i]];
+            unsigned w = forward ? a.to : a.from;
+            double d = du + a.weight;
+            if (d < tree.getDist(w)) {
+                bool queued = tree.getDist(w) != INF;
+                SearchTree::Node& node = tree.touch(w);
+                node.dist = node.key = d;
+                node.path = list[i];
+                if (queued) tree.queue.decreaseKey(&node);
+                else tree.queue.insert(&node);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Returns the contraction hierarchy of a metric, building it on the first call.
+ *
+ * A hierarchy built beforehand (see prepareHierarchies) is kept as is.
+ *
+ * @param driving True for driving times; false for walking times.
+ */
+const ContractionHierarchy& LoadedMap::contractionHierarchy(bool driving) const {
+    std::call_once(hierarchyBuilt[driving], [this, driving] {
+        if (hierarchy[driving].empty()) hierarchy[driving].build(csr, driving);
+    });
+    return hierarchy[driving];
+}
+
+/**
+ * @brief Builds the contraction hierarchies of both metrics of the map.
+ *
+ * @param map The loaded map.
+ */
+void prepareHierarchies(LoadedMap& map) {
+    map.hierarchy[false].build(map.csr, false);
+    map.hierarchy[true].build(map.csr, true);
+}
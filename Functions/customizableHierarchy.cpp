@@ -0,0 +1,385 @@
+/**
+ * @file CustomizableHierarchy.cpp
+ * @brief Implements the Customizable Contraction Hierarchies preprocessing, customization and the distance estimates
+ * of restricted queries.
+ */
+
+#include <algorithm>
+#include "../include/CustomizableHierarchy.h"
+#include "../include/CreatingMap.h"
+#include "../include/SearchWorkspace.h"
+
+/**
+ * @brief Starts a new query by moving to a new epoch.
+ *
+ * @param numVertices Number of vertices of the hierarchy.
+ */
+void PotentialCache::reset(size_t numVertices) {
+    if (stamp.size() != numVertices) {
+        dists.assign(numVertices, INF);
+        stamp.assign(numVertices, 0);
+        epoch = 0;
+    }
+    if (++epoch == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        epoch = 1;
+    }
+}
+
+/**
+ * @brief Orders the vertices by nested dissection: each part is split by a separator, which is ordered after
+ * the two halves it separates.
+ *
+ * A part is first split into its connected components. A connected part is searched breadth-first from a
+ * pseudo-peripheral vertex (the farthest vertex from any other). The vertices of one level that have a neighbour
+ * on the next level separate the part; the level with the fewest separator vertices per vertex on the smaller side
+ * is used, so that separators are small but the halves stay balanced.
+ * Parts are kept on an explicit stack, each with the first rank of the range it fills.
+ *
+ * @param adj Sorted undirected adjacency lists of the road topology.
+ * @param core Vertices to order; the others are ignored.
+ * @return The vertices of core in elimination order.
+ */
+std::vector<unsigned> CustomizableHierarchy::dissectionOrder(const std::vector<std::vector<unsigned>>& adj,
+                                                             const std::vector<unsigned>& core) const {
+    unsigned n = adj.size();
+    std::vector<unsigned> order(core.size());
+    std::vector<unsigned> part(n, 0), seen(n, 0), level(n, 0);
+    std::vector<unsigned> queue, counts, separating;
+    unsigned parts = 0, searches = 0;
+
+    // Breadth-first search restricted to one part; visits every vertex not yet seen in the current round
+    auto bfs = [&](unsigned root, unsigned id) {
+        queue.clear();
+        queue.push_back(root);
+        seen[root] = searches;
+        level[root] = 0;
+        for (size_t i = 0; i < queue.size(); i++) {
+            unsigned v = queue[i];
+            for (unsigned x : adj[v]) {
+                if (part[x] != id || seen[x] == searches) continue;
+                seen[x] = searches;
+                level[x] = level[v] + 1;
+                queue.push_back(x);
+            }
+        }
+    };
+
+    std::vector<std::pair<std::vector<unsigned>, unsigned>> stack;
+    stack.emplace_back(core, 0);
+    while (!stack.empty()) {
+        std::vector<unsigned> vertices = std::move(stack.back().first);
+        unsigned first = stack.back().second;
+        stack.pop_back();
+        if (vertices.size() <= DISSECTION_LEAF_SIZE) {
+            std::copy(vertices.begin(), vertices.end(), order.begin() + first);
+            continue;
+        }
+        unsigned id = ++parts;
+        for (unsigned v : vertices) part[v] = id;
+
+        searches++;
+        bfs(vertices[0], id);
+        if (queue.size() < vertices.size()) {
+            stack.emplace_back(queue, first);
+            first += queue.size();
+            for (unsigned v : vertices) {
+                if (seen[v] == searches) continue;
+                bfs(v, id);
+                stack.emplace_back(queue, first);
+                first += queue.size();
+            }
+            continue;
+        }
+
+        // Try the levels from a pseudo-peripheral vertex (the far end of a search from any vertex) and from the
+        // far end of those, and keep the smallest separator
+        unsigned root = queue.back(), bestRoot = root, cut = 0;
+        double bestRatio = INF;
+        for (int attempt = 0; attempt < 2; attempt++) {
+            searches++;
+            bfs(root, id);
+            unsigned levels = level[queue.back()] + 1;
+            counts.assign(levels, 0);
+            separating.assign(levels, 0);
+            for (unsigned v : queue) {
+                counts[level[v]]++;
+                for (unsigned x : adj[v]) {
+                    if (part[x] == id && level[x] == level[v] + 1) {
+                        separating[level[v]]++;
+                        break;
+                    }
+                }
+            }
+            size_t below = 0;
+            for (unsigned l = 0; l + 1 < levels; below += counts[l++]) {
+                size_t nearSize = below + counts[l] - separating[l], farSize = queue.size() - below - counts[l];
+                double ratio = static_cast<double>(separating[l]) / std::min(nearSize, farSize);
+                if (std::min(nearSize, farSize) == 0 || ratio >= bestRatio) continue;
+                bestRatio = ratio;
+                bestRoot = root;
+                cut = l;
+            }
+            root = queue.back();
+        }
+        searches++;
+        bfs(bestRoot, id);
+        // No level leaves vertices on both sides: split at the median vertex
+        if (bestRatio == INF) cut = std::min(level[queue[queue.size() / 2]], level[queue.back()] - 1);
+        std::vector<unsigned> nearHalf, farHalf, separator;
+        for (unsigned v : queue) {
+            bool separates = false;
+            if (level[v] == cut) {
+                for (unsigned x : adj[v]) separates = separates || (part[x] == id && level[x] == cut + 1);
+            }
+            if (separates) separator.push_back(v);
+            else if (level[v] <= cut) nearHalf.push_back(v);
+            else farHalf.push_back(v);
+        }
+
+        std::copy(separator.begin(), separator.end(), order.begin() + first + nearHalf.size() + farHalf.size());
+        if (!farHalf.empty()) stack.emplace_back(std::move(farHalf), first + nearHalf.size());
+        if (!nearHalf.empty()) stack.emplace_back(std::move(nearHalf), first);
+    }
+    return order;
+}
+
+/**
+ * @brief Eliminates the vertices, turning the remaining neighbours of each one into a clique: dead ends and chains
+ * of degree-2 vertices first, then the rest of the graph in nested dissection order.
+ *
+ * The neighbours left when a vertex is eliminated become its upward arcs, and the lowest of them its parent in the
+ * elimination tree. The lower triangles of every arc are listed once here, so customization does not have to
+ * search for them.
+ *
+ * @param csr CSR snapshot of the graph.
+ */
+void CustomizableHierarchy::build(const CsrGraph<Location>& csr) {
+    unsigned n = csr.getNumVertex();
+    std::vector<std::vector<unsigned>> adj(n);
+    auto link = [&adj](unsigned a, unsigned b) {
+        auto it = std::lower_bound(adj[a].begin(), adj[a].end(), b);
+        if (it == adj[a].end() || *it != b) adj[a].insert(it, b);
+    };
+    for (unsigned e = 0; e < csr.getNumEdges(); e++) {
+        unsigned a = csr.getSource(e), b = csr.getTarget(e);
+        if (csr.getDriving(e) == INF || a == b) continue;
+        link(a, b);
+        link(b, a);
+    }
+
+    std::vector<std::vector<unsigned>> upper(n);
+    std::vector<bool> eliminated(n, false);
+    std::vector<unsigned> order;
+    auto eliminate = [&](unsigned v) {
+        order.push_back(v);
+        eliminated[v] = true;
+        upper[v].swap(adj[v]);
+        for (unsigned x : upper[v]) adj[x].erase(std::lower_bound(adj[x].begin(), adj[x].end(), v));
+        for (size_t i = 0; i < upper[v].size(); i++) {
+            for (size_t j = i + 1; j < upper[v].size(); j++) {
+                link(upper[v][i], upper[v][j]);
+                link(upper[v][j], upper[v][i]);
+            }
+        }
+    };
+
+    // Dead ends and chains first: eliminating a vertex of degree 2 or less adds at most one arc and never raises
+    // the degree of its neighbours
+    std::vector<unsigned> low;
+    for (unsigned v = 0; v < n; v++) {
+        if (adj[v].size() <= 2) low.push_back(v);
+    }
+    while (!low.empty()) {
+        unsigned v = low.back();
+        low.pop_back();
+        if (eliminated[v]) continue;
+        eliminate(v);
+        for (unsigned x : upper[v]) {
+            if (adj[x].size() <= 2) low.push_back(x);
+        }
+    }
+
+    std::vector<unsigned> core;
+    for (unsigned v = 0; v < n; v++) {
+        if (!eliminated[v]) core.push_back(v);
+    }
+    for (unsigned v : dissectionOrder(adj, core)) eliminate(v);
+
+    rank.assign(n, 0);
+    for (unsigned i = 0; i < n; i++) rank[order[i]] = i;
+    treeParent.assign(n, NO_EDGE);
+    for (unsigned v = 0; v < n; v++) {
+        for (unsigned x : upper[v]) {
+            if (treeParent[v] == NO_EDGE || rank[x] < rank[treeParent[v]]) treeParent[v] = x;
+        }
+    }
+
+    upOffsets.assign(n + 1, 0);
+    upHeads.clear();
+    arcLow.clear();
+    for (unsigned v = 0; v < n; v++) {
+        upHeads.insert(upHeads.end(), upper[v].begin(), upper[v].end());
+        arcLow.insert(arcLow.end(), upper[v].size(), v);
+        upOffsets[v + 1] = upHeads.size();
+    }
+
+    unsigned m = upHeads.size();
+    // Lower triangles of each arc (v, u): pairs of arcs (w, v) and (w, u) for every w below both
+    triangleOffsets.assign(m + 1, 0);
+    for (unsigned w = 0; w < n; w++) {
+        for (unsigned i = upOffsets[w]; i < upOffsets[w + 1]; i++) {
+            for (unsigned j = i + 1; j < upOffsets[w + 1]; j++) triangleOffsets[findArc(upHeads[i], upHeads[j]) + 1]++;
+        }
+    }
+    for (unsigned a = 0; a < m; a++) triangleOffsets[a + 1] += triangleOffsets[a];
+    triangles.resize(triangleOffsets[m]);
+    std::vector<unsigned> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+    for (unsigned w = 0; w < n; w++) {
+        for (unsigned i = upOffsets[w]; i < upOffsets[w + 1]; i++) {
+            for (unsigned j = i + 1; j < upOffsets[w + 1]; j++) {
+                unsigned arc = findArc(upHeads[i], upHeads[j]);
+                bool iLower = rank[upHeads[i]] < rank[upHeads[j]];
+                triangles[fill[arc]++] = iLower ? std::make_pair(i, j) : std::make_pair(j, i);
+            }
+        }
+    }
+
+    for (int metric = 0; metric < 2; metric++) {
+        up[metric].clear();
+        down[metric].clear();
+    }
+}
+
+/**
+ * @brief Finds the arc between two vertices.
+ *
+ * @param a Dense index of one endpoint.
+ * @param b Dense index of the other endpoint.
+ * @return Arc index, or NO_EDGE if the vertices are not adjacent in the hierarchy.
+ */
+unsigned CustomizableHierarchy::findArc(unsigned a, unsigned b) const {
+    if (rank[a] > rank[b]) std::swap(a, b);
+    auto first = upHeads.begin() + upOffsets[a];
+    auto last = upHeads.begin() + upOffsets[a + 1];
+    auto it = std::lower_bound(first, last, b);
+    return it != last && *it == b ? static_cast<unsigned>(it - upHeads.begin()) : NO_EDGE;
+}
+
+/**
+ * @brief Computes the weights of every arc for one metric: original segments first, then the lower triangles
+ * of each arc, by elimination order of its lower endpoint.
+ *
+ * @param csr CSR snapshot of the graph the hierarchy was built for.
+ * @param driving True to use driving times; false to use walking times.
+ */
+void CustomizableHierarchy::customize(const CsrGraph<Location>& csr, bool driving) {
+    unsigned n = csr.getNumVertex();
+    std::vector<double>& upW = up[driving];
+    std::vector<double>& downW = down[driving];
+    upW.assign(upHeads.size(), INF);
+    downW.assign(upHeads.size(), INF);
+
+    for (unsigned e = 0; e < csr.getNumEdges(); e++) {
+        unsigned a = csr.getSource(e), b = csr.getTarget(e);
+        if (csr.getDriving(e) == INF || a == b) continue;
+        double cost = driving ? csr.getDriving(e) : csr.getWalking(e);
+        unsigned arc = findArc(a, b);
+        if (rank[a] < rank[b]) upW[arc] = std::min(upW[arc], cost);
+        else downW[arc] = std::min(downW[arc], cost);
+    }
+
+    std::vector<unsigned> byRank(n);
+    for (unsigned v = 0; v < n; v++) byRank[rank[v]] = v;
+    for (unsigned v : byRank) {
+        for (unsigned arc = upOffsets[v]; arc < upOffsets[v + 1]; arc++) {
+            for (unsigned k = triangleOffsets[arc]; k < triangleOffsets[arc + 1]; k++) {
+                unsigned p = triangles[k].first, q = triangles[k].second;
+                upW[arc] = std::min(upW[arc], downW[p] + upW[q]);
+                downW[arc] = std::min(downW[arc], downW[q] + upW[p]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Searches the elimination tree from the destination, following the downward weights in reverse.
+ *
+ * The ancestors of a vertex are in increasing rank order and include all its upper neighbours, so walking them
+ * once and relaxing their arcs gives, for every ancestor x of t, the shortest path from x down to t in the hierarchy,
+ * without a priority queue.
+ *
+ * @param ws Workspace of the query; ws.backward receives the distances.
+ * @param t Dense index of the destination.
+ * @param driving True to use driving times; false to use walking times.
+ */
+void CustomizableHierarchy::searchTo(SearchWorkspace& ws, unsigned t, bool driving) const {
+    SearchTree& bwd = ws.backward;
+    bwd.reset();
+    ws.potentials.reset(rank.size());
+    bwd.touch(t).dist = 0;
+    for (unsigned v = t; v != NO_EDGE; v = treeParent[v]) {
+        double dv = bwd.getDist(v);
+        if (dv == INF) continue;
+        for (unsigned a = upOffsets[v]; a < upOffsets[v + 1]; a++) {
+            double d = dv + down[driving][a];
+            if (d < bwd.getDist(upHeads[a])) {
+                SearchTree::Node& node = bwd.touch(upHeads[a]);
+                node.dist = node.key = d;
+                node.path = a;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Distance from a vertex to the destination of searchTo(): the best of going down from the vertex itself,
+ * if it is an ancestor of the destination, and of taking one upward arc and continuing from its head.
+ *
+ * The heads are ancestors of the vertex, so the ancestors not computed yet are computed first, from the top.
+ * An ancestor that was computed has all of its own ancestors computed too.
+ *
+ * @param ws Workspace of the query.
+ * @param v Dense index of the vertex.
+ * @param driving True to use driving times; false to use walking times.
+ */
+double CustomizableHierarchy::potential(SearchWorkspace& ws, unsigned v, bool driving) const {
+    PotentialCache& cache = ws.potentials;
+    if (cache.has(v)) return cache.get(v);
+
+    std::vector<unsigned>& pending = cache.pending;
+    pending.clear();
+    for (unsigned x = v; x != NO_EDGE && !cache.has(x); x = treeParent[x]) pending.push_back(x);
+    for (auto it = pending.rbegin(); it != pending.rend(); ++it) {
+        unsigned x = *it;
+        double dist = ws.backward.getDist(x);
+        for (unsigned a = upOffsets[x]; a < upOffsets[x + 1]; a++) dist = std::min(dist, up[driving][a] + cache.get(upHeads[a]));
+        cache.set(x, dist);
+    }
+    return cache.get(v);
+}
+
+/**
+ * @brief Builds the customizable hierarchy the first time it is needed and customizes it for both metrics.
+ */
+const CustomizableHierarchy& LoadedMap::customizableHierarchy() const {
+    std::call_once(customizableBuilt, [this] {
+        if (!customizable.isCustomized(false)) {
+            customizable.build(csr);
+            customizable.customize(csr, false);
+            customizable.customize(csr, true);
+        }
+    });
+    return customizable;
+}
+
+/**
+ * @brief Builds the customizable hierarchy of the map and customizes it for the walking and the driving metric.
+ *
+ * @param map The loaded map.
+ */
+void prepareCustomizableHierarchy(LoadedMap& map) {
+    map.customizable.build(map.csr);
+    map.customizable.customize(map.csr, false);
+    map.customizable.customize(map.csr, true);
+}
@@ -11,50 +11,52 @@
 #include <algorithm>
 
 /**
- * @brief Marks the specified edges (segments) as ignored in the graph.
+ * @brief Bans the specified edges (segments) in the workspace of the current query.
  * 
- * @param avoidSegments A list of pairs representing edges to ignore (fromID, toID).
+ * @param map The loaded map.
+ * @param ws Workspace of the current query.
+ * @param avoidSegments A list of pairs representing edges to ban (fromID, toID).
  */
-void markIgnoredEdges(const std::vector<std::pair<int,int>>& avoidSegments) {
+void markIgnoredEdges(const LoadedMap& map, SearchWorkspace& ws, const std::vector<std::pair<int,int>>& avoidSegments) {
     for (auto &seg : avoidSegments) {
         int fromID = seg.first;
         int toID   = seg.second;
-        if (idmap.find(fromID) == idmap.end()) continue;
-        Vertex<Location>* fromV = idmap[fromID];
-        for (auto e : fromV->getAdj()) {
-            if (e->getDest()->getInfo().id == toID) {
-                e->setIgnored(true);
+        int fromIdx = map.indexOf(fromID);
+        if (fromIdx == -1) continue;
+        for (unsigned e : map.csr.edges(fromIdx)) {
+            if (map.idOf(map.csr.getTarget(e)) == toID) {
+                ws.banEdge(e);
             }
         }
     }
 }
 
 /**
- * @brief Builds the driving path in reverse from end to start, using a path map.
+ * @brief Builds the driving path in reverse from end to start, using a search tree.
  *
  * @param startID Origin node ID.
  * @param endID Destination node ID.
  * @param driving True if driving path, false if walking.
  * @param accTime Reference to accumulate total travel time.
- * @param pathMap Map of node IDs to edges used to reach them.
+ * @param map The loaded map.
+ * @param tree Search tree holding the edge used to reach each node.
  * @return Vector with the sequence of node IDs from start to end (reversed).
  */
-std::vector<int> buildBackwardPath(int startID, int endID, bool driving, double &accTime, const std::unordered_map<int, Edge<Location>*>& pathMap) {
+std::vector<int> buildBackwardPath(int startID, int endID, bool driving, double &accTime, const LoadedMap& map, const SearchTree& tree) {
     std::vector<int> path;
     int currentID = endID;
     path.push_back(endID);
 
     while (true) {
-        auto it = pathMap.find(currentID);
-        if (it == pathMap.end() || it->second == nullptr) {
+        unsigned edge = tree.getPath(map.indexOf(currentID));
+        if (edge == NO_EDGE) {
             accTime = INF;
             break;
         }
-        Edge<Location>* edge = it->second;
-        double cost = driving ? edge->getDriving() : edge->getWalking();
+        double cost = driving ? map.csr.getDriving(edge) : map.csr.getWalking(edge);
         accTime += cost;
 
-        int origID = edge->getOrig()->getInfo().id;
+        int origID = map.idOf(map.csr.getSource(edge));
         path.push_back(origID);
 
         if (origID == startID) break;
@@ -66,32 +68,32 @@ std::vector<int> buildBackwardPath(int startID, int endID, bool driving, double
 }
 
 /**
- * @brief Builds the walking path from start to end, using a path map.
+ * @brief Builds the walking path from start to end, using a search tree.
  *
  * @param startID Starting node ID (e.g., parking).
  * @param endID Destination node ID.
  * @param driving False for walking path.
  * @param accTime Reference to accumulate total walking time.
- * @param pathMap Map of node IDs to edges used to reach them.
+ * @param map The loaded map.
+ * @param tree Search tree holding the edge used to reach each node.
  * @return Vector with the sequence of node IDs from start to end.
  */
-std::vector<int> buildForwardPath(int startID, int endID, bool driving, double &accTime, const std::unordered_map<int, Edge<Location>*>& pathMap) {
+std::vector<int> buildForwardPath(int startID, int endID, bool driving, double &accTime, const LoadedMap& map, const SearchTree& tree) {
     std::vector<int> path;
     int currentID = startID;
     path.push_back(currentID);
 
     while (true) {
-        auto it = pathMap.find(currentID);
-        if (it == pathMap.end() || it->second == nullptr) {
+        unsigned edge = tree.getPath(map.indexOf(currentID));
+        if (edge == NO_EDGE) {
             accTime = INF;
             break;
         }
 
-        Edge<Location>* edge = it->second;
-        double cost = driving ? edge->getDriving() : edge->getWalking();
+        double cost = driving ? map.csr.getDriving(edge) : map.csr.getWalking(edge);
         accTime += cost;
 
-        int nextID = edge->getDest()->getInfo().id;
+        int nextID = map.idOf(map.csr.getTarget(edge));
         path.push_back(nextID);
 
         if (nextID == endID) break;
@@ -104,9 +106,12 @@ std::vector<int> buildForwardPath(int startID, int endID, bool driving, double &
 /**
  * @brief Plans an environmentally friendly route with parking and walking, respecting max walking time.
  * 
- * Tries all valid parking nodes and selects the one with the shortest total time,
- * preferring longer walks if time is equal.
+ * Only the parking nodes within walking distance of the destination are considered, and the
+ * driving search stops as soon as all of them are settled. Selects the one with the shortest
+ * total time, preferring longer walks if time is equal.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @param origin Origin node ID.
  * @param destination Destination node ID.
  * @param maxWalkTime Maximum allowed walking time from parking to destination.
@@ -114,18 +119,16 @@ std::vector<int> buildForwardPath(int startID, int endID, bool driving, double &
  * @param avoidSegments Set of edges to avoid.
  * @return A structure containing the driving path, walking path, total time, and parking location.
  */
-EnvironmentallyFriendlyRouteResult planEnvironmentallyFriendlyRoute(int origin, int destination, int maxWalkTime,
+EnvironmentallyFriendlyRouteResult planEnvironmentallyFriendlyRoute(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, int maxWalkTime,
                                                                     const std::unordered_set<int>& ignoreVertex,
                                                                     const std::vector<std::pair<int, int>>& avoidSegments) {
-    Graph<Location> g;
-    createMap(g);
     EnvironmentallyFriendlyRouteResult result;
     result.origin = origin;
     result.destination = destination;
-    if (idmap.find(origin) == idmap.end()) {
+    if (!map.contains(origin)) {
         result.origExists = false;
     }
-    if ( idmap.find(destination) == idmap.end()) {
+    if (!map.contains(destination)) {
         result.destExists = false;
     }
 
@@ -133,48 +136,49 @@ EnvironmentallyFriendlyRouteResult planEnvironmentallyFriendlyRoute(int origin,
         return result;
     }
 
-    markIgnoredEdges(avoidSegments);
-
-    dijkstra(&g, origin, true, false, ignoreVertex);
-
-    std::unordered_map<int, double> driveDist;
-    std::unordered_map<int, Edge<Location>*> drivePath;
-    for (auto v : g.getVertexSet()) {
-        driveDist[v->getInfo().id] = v->getDist();
-        drivePath[v->getInfo().id] = v->getPath();
+    ws.reset();
+    markIgnoredEdges(map, ws, avoidSegments);
+
+    // Walking tree towards the destination, bounded by the walking limit: only parkings inside it are candidates
+    dijkstraWithin(map, ws, ws.backward, destination, maxWalkTime, false, true, ignoreVertex);
+
+    std::vector<int> candidates;
+    for (int v : ws.backward.getTouched()) {
+        const Location& location = map.csr.getInfo(v);
+        if (location.parking != 1) continue;
+        if (location.id == origin || location.id == destination) continue;
+        double wTime = ws.backward.getDist(v);
+        if (wTime > maxWalkTime || wTime <= 1e-9) continue;
+        if (ws.isVertexIgnored(v)) continue;
+        candidates.push_back(v);
     }
-
-    dijkstra(&g, destination, false, true, ignoreVertex);
-
-    std::unordered_map<int, double> walkDist;
-    std::unordered_map<int, Edge<Location>*> walkPath;
-    for (auto v : g.getVertexSet()) {
-        walkDist[v->getInfo().id] = v->getDist();
-        walkPath[v->getInfo().id] = v->getPath();
+    if (candidates.empty()) {
+        result.pathFound = false;
+        return result;
     }
+    // Scan in index order so that ties are resolved as before
+    std::sort(candidates.begin(), candidates.end());
+
+    // Driving tree from the origin, stopping once every candidate parking is settled
+    std::vector<int> candidateIDs;
+    candidateIDs.reserve(candidates.size());
+    for (int v : candidates) candidateIDs.push_back(map.idOf(v));
+    dijkstraToTargets(map, ws, ws.forward, origin, candidateIDs, true, false, ignoreVertex);
 
     double bestTotalTime = INF;
     double bestWalkTime = 0.0;
     int bestParking = -1;
-    for (auto v : g.getVertexSet()) {
-
-        if (v->getInfo().parking != 1) continue;
-        int pid = v->getInfo().id;
-        if (ignoreVertex.find(pid) != ignoreVertex.end()) continue;
-
-        double dTime = driveDist[pid];
-        double wTime = walkDist[pid];
+    for (int v : candidates) {
+        double dTime = ws.forward.getDist(v);
+        double wTime = ws.backward.getDist(v);
 
-        if (dTime == INF || wTime == INF) continue;
-        if (pid == origin || pid == destination) continue;
-        if (wTime > maxWalkTime) continue;
-        if (dTime <= 1e-9 || wTime <= 1e-9) continue;
+        if (dTime == INF || dTime <= 1e-9) continue;
 
         double total = dTime + wTime;
         if (total < bestTotalTime || (std::fabs(total - bestTotalTime) < 1e-9 && wTime > bestWalkTime)) {
             bestTotalTime = total;
             bestWalkTime  = wTime;
-            bestParking   = pid;
+            bestParking   = map.idOf(v);
         }
     }
 
@@ -184,8 +188,8 @@ EnvironmentallyFriendlyRouteResult planEnvironmentallyFriendlyRoute(int origin,
     }
 
     result.parkingNode = bestParking;
-    result.drivingPath = buildBackwardPath(origin, bestParking, true, result.drivingTime, drivePath);
-    result.walkingPath = buildForwardPath(bestParking, destination, false, result.walkingTime, walkPath);
+    result.drivingPath = buildBackwardPath(origin, bestParking, true, result.drivingTime, map, ws.forward);
+    result.walkingPath = buildForwardPath(bestParking, destination, false, result.walkingTime, map, ws.backward);
     result.totalTime = result.drivingTime + result.walkingTime;
     result.pathFound = true;
 
@@ -0,0 +1,173 @@
+/**
+ * @file floydWarshall.cpp
+ * @brief Implements the blocked Floyd-Warshall algorithm, its tile kernels and the textbook reference.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include "../include/FloydWarshall.h"
+#include "../include/WorkStealingScheduler.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MYGPS_HAVE_AVX2 1
+#endif
+
+// Cache line size, in bytes, that the rows are aligned to
+#define DISTANCE_MATRIX_ALIGNMENT 64
+
+DistanceMatrix::DistanceMatrix(unsigned n)
+    : numVertex(n), padded((n + FLOYD_WARSHALL_BLOCK - 1) / FLOYD_WARSHALL_BLOCK * FLOYD_WARSHALL_BLOCK) {
+    size_t slack = DISTANCE_MATRIX_ALIGNMENT / sizeof(double);
+    stride = padded + slack;
+    storage.assign(padded * stride + slack, INF);
+    uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+    size_t skip = (DISTANCE_MATRIX_ALIGNMENT - address % DISTANCE_MATRIX_ALIGNMENT) % DISTANCE_MATRIX_ALIGNMENT;
+    cells = storage.data() + skip / sizeof(double);
+    for (unsigned i = 0; i < n; i++) at(i, i) = 0;
+}
+
+DistanceMatrix segmentMatrix(const CsrGraph<Location>& csr, bool driving) {
+    DistanceMatrix matrix(csr.getNumVertex());
+    for (unsigned u = 0; u < csr.getNumVertex(); u++) {
+        for (unsigned e : csr.edges(u)) {
+            if (csr.getDriving(e) == INF) continue;
+            double cost = driving ? csr.getDriving(e) : csr.getWalking(e);
+            double& cell = matrix.at(u, csr.getTarget(e));
+            cell = std::min(cell, cost);
+        }
+    }
+    return matrix;
+}
+
+void floydWarshallReference(DistanceMatrix& matrix) {
+    unsigned n = matrix.size();
+    for (unsigned k = 0; k < n; k++) {
+        for (unsigned i = 0; i < n; i++) {
+            for (unsigned j = 0; j < n; j++) {
+                matrix.at(i, j) = std::min(matrix.at(i, j), matrix.at(i, k) + matrix.at(k, j));
+            }
+        }
+    }
+}
+
+namespace {
+
+/**
+ * @brief Relaxes tile c through tiles a and b: c[i][j] = min(c[i][j], a[i][k] + b[k][j]), for k in order.
+ *
+ * c may be a or b (the diagonal tile and the tiles of its row and column): the row and the column of k do
+ * not change during step k, since the diagonal entries are 0 (or INF for the padding), so the update stays exact.
+ */
+void relaxTile(double* c, const double* a, const double* b, size_t stride) {
+    for (unsigned k = 0; k < FLOYD_WARSHALL_BLOCK; k++) {
+        const double* bk = b + k * stride;
+        for (unsigned i = 0; i < FLOYD_WARSHALL_BLOCK; i++) {
+            double aik = a[i * stride + k];
+            double* ci = c + i * stride;
+            for (unsigned j = 0; j < FLOYD_WARSHALL_BLOCK; j++) ci[j] = std::min(ci[j], aik + bk[j]);
+        }
+    }
+}
+
+#ifdef MYGPS_HAVE_AVX2
+/**
+ * @brief relaxTile() with four distances per instruction, on aligned rows.
+ */
+__attribute__((target("avx2"))) void relaxTileAvx2(double* c, const double* a, const double* b, size_t stride) {
+    for (unsigned k = 0; k < FLOYD_WARSHALL_BLOCK; k++) {
+        const double* bk = b + k * stride;
+        for (unsigned i = 0; i < FLOYD_WARSHALL_BLOCK; i++) {
+            __m256d aik = _mm256_broadcast_sd(a + i * stride + k);
+            double* ci = c + i * stride;
+            for (unsigned j = 0; j < FLOYD_WARSHALL_BLOCK; j += 4) {
+                __m256d through = _mm256_add_pd(aik, _mm256_load_pd(bk + j));
+                _mm256_store_pd(ci + j, _mm256_min_pd(_mm256_load_pd(ci + j), through));
+            }
+        }
+    }
+}
+
+/**
+ * @brief relaxTileAvx2() for a tile c distinct from a and b: a block of four rows by eight columns of c stays
+ * in registers while k runs through the tile, so c is read and written once per tile instead of once per k.
+ */
+__attribute__((target("avx2"))) void relaxIndependentTileAvx2(double* c, const double* a, const double* b, size_t stride) {
+    for (unsigned i = 0; i < FLOYD_WARSHALL_BLOCK; i += 4) {
+        for (unsigned j = 0; j < FLOYD_WARSHALL_BLOCK; j += 8) {
+            __m256d lo[4], hi[4];
+            for (unsigned r = 0; r < 4; r++) {
+                lo[r] = _mm256_load_pd(c + (i + r) * stride + j);
+                hi[r] = _mm256_load_pd(c + (i + r) * stride + j + 4);
+            }
+            for (unsigned k = 0; k < FLOYD_WARSHALL_BLOCK; k++) {
+                __m256d b0 = _mm256_load_pd(b + k * stride + j), b1 = _mm256_load_pd(b + k * stride + j + 4);
+                for (unsigned r = 0; r < 4; r++) {
+                    __m256d x = _mm256_broadcast_sd(a + (i + r) * stride + k);
+                    lo[r] = _mm256_min_pd(lo[r], _mm256_add_pd(x, b0));
+                    hi[r] = _mm256_min_pd(hi[r], _mm256_add_pd(x, b1));
+                }
+            }
+            for (unsigned r = 0; r < 4; r++) {
+                _mm256_store_pd(c + (i + r) * stride + j, lo[r]);
+                _mm256_store_pd(c + (i + r) * stride + j + 4, hi[r]);
+            }
+        }
+    }
+}
+#endif
+
+typedef void (*TileKernel)(double*, const double*, const double*, size_t);
+
+/**
+ * @brief Kernels for the tiles that share data with the diagonal tile (the first two phases) and for the others.
+ */
+struct TileKernels {
+    TileKernel dependent;
+    TileKernel independent;
+};
+
+TileKernels selectKernels() {
+#ifdef MYGPS_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) return TileKernels{relaxTileAvx2, relaxIndependentTileAvx2};
+#endif
+    return TileKernels{relaxTile, relaxTile};
+}
+
+} // namespace
+
+bool floydWarshallUsesAvx2() {
+    return selectKernels().dependent != relaxTile;
+}
+
+/**
+ * @brief Runs the three phases for each diagonal tile, the last two on a work-stealing pool.
+ *
+ * Task t of the second phase is tile (k, t) or, past the row, tile (t - blocks, k); task t of the third phase
+ * is tile (t / blocks, t % blocks). Tiles of the row or column of k are skipped in the phases they do not belong to.
+ */
+void floydWarshall(DistanceMatrix& matrix, unsigned threads) {
+    TileKernels kernels = selectKernels();
+    size_t stride = matrix.getStride();
+    size_t blocks = matrix.getPaddedSize() / FLOYD_WARSHALL_BLOCK;
+    auto tile = [&](size_t i, size_t j) { return matrix.row(i * FLOYD_WARSHALL_BLOCK) + j * FLOYD_WARSHALL_BLOCK; };
+
+    WorkStealingScheduler scheduler(std::max(1u, threads));
+    for (size_t k = 0; k < blocks; k++) {
+        double* diagonal = tile(k, k);
+        kernels.dependent(diagonal, diagonal, diagonal, stride);
+
+        scheduler.run(2 * blocks, [&](unsigned, size_t t) {
+            if (t < blocks) {
+                if (t != k) kernels.dependent(tile(k, t), diagonal, tile(k, t), stride);
+            } else if (t - blocks != k) {
+                kernels.dependent(tile(t - blocks, k), tile(t - blocks, k), diagonal, stride);
+            }
+        });
+
+        scheduler.run(blocks * blocks, [&](unsigned, size_t t) {
+            size_t i = t / blocks, j = t % blocks;
+            if (i != k && j != k) kernels.independent(tile(i, j), tile(i, k), tile(k, j), stride);
+        });
+    }
+}
@@ -5,32 +5,56 @@
  * This file includes logic for verifying input, running Dijkstra's algorithm, and formatting the output.
  */
 
+#include <algorithm>
 #include <unordered_set>
 #include "..//include//CreatingMap.h"
+#include "../include/AlternativeRoutes.h"
 #include "../include/IndependentRoutePlanning.h"
+#include "../include/KShortestPaths.h"
 #include "../include/RoutePlanningUtils.h"
 
+/**
+ * @brief Converts a route given as CSR edges into location IDs, adding up its driving time.
+ *
+ * @param map The loaded map.
+ * @param origin ID of the first location of the route.
+ * @param edges CSR indices of the edges of the route, in order.
+ * @param time Reference to accumulate the total driving time.
+ * @return The IDs of the locations of the route, origin included.
+ */
+static std::vector<int> routeLocations(const LoadedMap& map, int origin, const std::vector<unsigned>& edges, double& time) {
+    std::vector<int> res;
+    res.push_back(origin);
+    for (unsigned e : edges) {
+        time += map.csr.getDriving(e);
+        res.push_back(map.idOf(map.csr.getTarget(e)));
+    }
+    return res;
+}
+
 /**
  * @brief Calculates the fastest route (and optionally an alternative route) between two locations.
  *
- * Uses Dijkstra's algorithm to find the shortest path from origin to destination.
- * If @p doAltPath is true, it also calculates an alternative path avoiding intermediate nodes from the best path.
+ * Without an alternative, the selected algorithm finds the shortest path. With one, a single forward and a
+ * single backward search give both (see findAlternativeRoute); with an algorithm other than Dijkstra, that
+ * algorithm still finds the fastest route and the trees only provide the alternative.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @param origin The ID of the origin location.
  * @param destination The ID of the destination location.
  * @param doAltPath Flag indicating whether to compute the alternative route.
+ * @param algorithm Search algorithm used for the fastest route.
  * @return IndependentRoutesResult Struct containing the result of the route(s) calculation.
  */
-IndependentRoutesResult planFastestRoute(int origin, int destination, bool doAltPath) {
-    Graph<Location> cityGraph;  // Single instance of the graph
-    createMap(cityGraph);
-
+IndependentRoutesResult planFastestRoute(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, bool doAltPath,
+                                         SearchAlgorithm algorithm) {
     IndependentRoutesResult result;
 
-    if (idmap.find(origin) == idmap.end()) {
+    if (!map.contains(origin)) {
         result.origExists = false;
     }
-    if (idmap.find(destination) == idmap.end()) {
+    if (!map.contains(destination)) {
         result.destExists = false;
     }
 
@@ -38,27 +62,35 @@ IndependentRoutesResult planFastestRoute(int origin, int destination, bool doAlt
         return result;
     }
 
-    std::unordered_set<int> frstpath; // Stores the nodes that are part of the shortest path
-    dijkstra(&cityGraph, origin, false, false, frstpath);
-
-    result.bestTime = 0;
-    result.bestPath = getBestPath(&cityGraph, origin, destination, result.bestTime);
+    AlternativeRoute routes;
+    if (!doAltPath || algorithm != SearchAlgorithm::Dijkstra) {
+        ws.reset();
+        std::unordered_set<int> noIgnore;
+        shortestPath(map, ws, origin, destination, false, noIgnore, algorithm);
+        unsigned t = map.indexOf(destination);
+        routes.found = ws.forward.getDist(t) != INF;
+        for (unsigned v = t, e; routes.found && (e = ws.forward.getPath(v)) != NO_EDGE; v = map.csr.getSource(e)) {
+            routes.shortest.push_back(e);
+        }
+        std::reverse(routes.shortest.begin(), routes.shortest.end());
+        if (doAltPath && routes.found) {
+            routes = findAlternativeRoute(map, ws, origin, destination, false, &routes.shortest);
+        }
+    } else {
+        routes = findAlternativeRoute(map, ws, origin, destination, false);
+    }
 
-    result.foundBest = !result.bestPath.empty();
+    result.foundBest = routes.found;
     if (!result.foundBest) {
         return result;
     }
+    result.bestTime = 0;
+    result.bestPath = routeLocations(map, origin, routes.shortest, result.bestTime);
 
-    // Store nodes in shortest path to avoid in alternative path calculation
-    for (size_t i = 1; i < result.bestPath.size() - 1; i++) {
-        frstpath.insert(result.bestPath[i]);
-    }
-
-    if (doAltPath) {
+    if (doAltPath && routes.foundAlternative) {
         result.altTime = 0;
-        dijkstra(&cityGraph, origin, false, false, frstpath);
-        result.altPath = getBestPath(&cityGraph, origin, destination, result.altTime);
-        result.foundAlt = !result.altPath.empty() && result.bestPath != result.altPath;
+        result.altPath = routeLocations(map, origin, routes.alternative, result.altTime);
+        result.foundAlt = true;
     }
 
     return result;
@@ -122,4 +154,89 @@ void outputIndependentRouteResult(const IndependentRoutesResult& result, std::os
         out << "No Alternative Path Found\n";
         return;
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Calculates up to K distinct loopless routes between two locations, fastest first.
+ *
+ * Searches with walking times, like planFastestRoute(), and reports the driving time of each route. The first
+ * route comes from the same Dijkstra search (or all-pairs table lookup) as planFastestRoute()'s best route.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
+ * @param origin The ID of the origin location.
+ * @param destination The ID of the destination location.
+ * @param k Maximum number of routes.
+ * @return RankedRoutesResult Struct containing the routes found.
+ */
+RankedRoutesResult planKFastestRoutes(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, unsigned k) {
+    RankedRoutesResult result;
+    result.origExists = map.contains(origin);
+    result.destExists = map.contains(destination);
+    if (!result.origExists || !result.destExists) {
+        return result;
+    }
+
+    // The first route is the one planFastestRoute() reports, so ties are broken the same way
+    ws.reset();
+    std::unordered_set<int> noIgnore;
+    shortestPath(map, ws, origin, destination, false, noIgnore, SearchAlgorithm::Dijkstra);
+    unsigned t = map.indexOf(destination);
+    if (ws.forward.getDist(t) == INF) {
+        return result;
+    }
+    std::vector<unsigned> shortest;
+    for (unsigned v = t, e; (e = ws.forward.getPath(v)) != NO_EDGE; v = map.csr.getSource(e)) {
+        shortest.push_back(e);
+    }
+    std::reverse(shortest.begin(), shortest.end());
+
+    for (const RankedRoute& route : kShortestPaths(map, ws, origin, destination, k, false, &shortest)) {
+        double time = 0;
+        result.paths.push_back(routeLocations(map, origin, route.edges, time));
+        result.times.push_back(time);
+    }
+    return result;
+}
+
+/**
+ * @brief Outputs the K fastest routes to the given output stream.
+ *
+ * Writes the origin and destination, then one `Route<i>:ids(time)` line per route, or the same messages as
+ * outputIndependentRouteResult() when an ID is invalid or no route exists.
+ *
+ * @param result The routes found.
+ * @param out The output stream to write to (e.g., std::cout or file).
+ * @param origin The ID of the origin location.
+ * @param destination The ID of the destination location.
+ */
+void outputRankedRoutesResult(const RankedRoutesResult& result, std::ostream& out, int origin, int destination) {
+    out << "Source:" << origin << "\n";
+    out << "Destination:" << destination << "\n";
+
+    if (!result.origExists) {
+        out << "Origin ID is invalid! " << "\n";
+        return;
+    }
+
+    if (!result.destExists) {
+        out << "Destiny ID is invalid! " << "\n";
+        return;
+    }
+
+    if (result.paths.empty()) {
+        out << "No Path Found\n";
+        return;
+    }
+
+    for (size_t r = 0; r < result.paths.size(); r++) {
+        out << "Route" << r + 1 << ":";
+        for (size_t i = 0; i < result.paths[r].size(); i++) {
+            out << result.paths[r][i];
+            if (i < result.paths[r].size() - 1) {
+                out << ",";
+            }
+        }
+        out << "(" << result.times[r] << ")\n";
+    }
+}
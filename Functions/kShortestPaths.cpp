@@ -0,0 +1,95 @@
+/**
+ * @file kShortestPaths.cpp
+ * @brief Implements Yen's K shortest loopless routes, with spur searches guided by one reverse search.
+ */
+
+#include <algorithm>
+#include <map>
+#include <unordered_set>
+#include "../include/KShortestPaths.h"
+#include "../include/RoutePlanningUtils.h"
+
+/**
+ * @brief Computes the K shortest loopless routes between two locations, shortest first.
+ *
+ * Unless given, the first route is the reverse tree path from the origin. Spur vertex i of a route is the source of its
+ * edge i; its root is the route's first i edges, whose sources are ignored by the spur search. Every banned edge
+ * leaves the spur vertex, so the tree path of the spur vertex avoids the bans unless it starts with one.
+ * Candidates are kept in a map ordered by length and edges, which also merges a route found from two parents;
+ * the smaller deviation index is kept, so no spur vertex is skipped.
+ */
+std::vector<RankedRoute> kShortestPaths(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination,
+                                        unsigned k, bool driving, const std::vector<unsigned>* shortest) {
+    static const std::unordered_set<int> noIgnore;
+    const CsrGraph<Location>& csr = map.csr;
+    SearchTree& fwd = ws.forward;
+    SearchTree& bwd = ws.backward;
+    std::vector<RankedRoute> routes;
+
+    ws.reset();
+    unsigned s = map.indexOf(origin), t = map.indexOf(destination);
+    reverseDijkstra(map, ws, bwd, destination, driving, noIgnore);
+    if (k == 0 || bwd.getDist(s) == INF) return routes;
+
+    auto length = [&csr, driving](const std::vector<unsigned>& edges) {
+        double dist = 0;
+        for (unsigned e : edges) dist += driving ? csr.getDriving(e) : csr.getWalking(e);
+        return dist;
+    };
+
+    RankedRoute first;
+    if (shortest != nullptr) {
+        first.edges = *shortest;
+    } else {
+        for (unsigned v = s, e; (e = bwd.getPath(v)) != NO_EDGE; v = csr.getTarget(e)) first.edges.push_back(e);
+    }
+    first.dist = length(first.edges);
+    routes.push_back(std::move(first));
+
+    std::map<std::pair<double, std::vector<unsigned>>, unsigned> candidates;
+    std::unordered_set<int> root;
+    while (routes.size() < k) {
+        const RankedRoute& last = routes.back();
+        root.clear();
+        unsigned spur = s;
+        for (unsigned i = 0; i < last.edges.size(); root.insert(map.idOf(spur)), spur = csr.getTarget(last.edges[i++])) {
+            if (i < last.deviation) continue;
+
+            // Ban the next edge of every accepted route with the same root, and the root itself
+            ws.reset();
+            for (const RankedRoute& route : routes) {
+                if (route.edges.size() > i && std::equal(last.edges.begin(), last.edges.begin() + i, route.edges.begin())) {
+                    ws.banEdge(route.edges[i]);
+                }
+            }
+            ws.setIgnoredVertices(map, root);
+
+            std::vector<unsigned> edges(last.edges.begin(), last.edges.begin() + i);
+            bool clear = !ws.isEdgeBanned(bwd.getPath(spur));
+            for (unsigned v = spur, e; clear && (e = bwd.getPath(v)) != NO_EDGE; v = csr.getTarget(e)) {
+                clear = !ws.isVertexIgnored(csr.getTarget(e));
+                edges.push_back(e);
+            }
+            if (!clear) {
+                edges.resize(i);
+                guidedSearch(map, ws, fwd, map.idOf(spur), destination, bwd, driving, root);
+                if (fwd.getDist(t) == INF) continue;
+                for (unsigned v = t, e; (e = fwd.getPath(v)) != NO_EDGE; v = csr.getSource(e)) edges.push_back(e);
+                std::reverse(edges.begin() + i, edges.end());
+            }
+
+            double dist = length(edges);
+            auto inserted = candidates.emplace(std::make_pair(dist, std::move(edges)), i);
+            if (!inserted.second) inserted.first->second = std::min(inserted.first->second, i);
+        }
+        if (candidates.empty()) break;
+
+        RankedRoute next;
+        next.dist = candidates.begin()->first.first;
+        next.edges = candidates.begin()->first.second;
+        next.deviation = candidates.begin()->second;
+        candidates.erase(candidates.begin());
+        routes.push_back(std::move(next));
+    }
+    return routes;
+}
@@ -0,0 +1,229 @@
+/**
+ * @file Landmarks.cpp
+ * @brief Implements the landmark preprocessing used by the ALT search.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_set>
+#include "../include/Landmarks.h"
+#include "../include/CreatingMap.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+
+static const char LANDMARK_MAGIC[8] = {'M', 'G', 'P', 'S', 'A', 'L', 'T', '1'};
+
+/**
+ * @brief Mixes a value into an FNV-1a hash.
+ */
+static void mix(unsigned long long& hash, unsigned long long value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= 1099511628211ULL;
+    }
+}
+
+/**
+ * @brief Computes the fingerprint of a graph.
+ *
+ * @param csr Graph to fingerprint.
+ * @return 64-bit FNV-1a hash of the vertex IDs and of the endpoints and weights of every edge.
+ */
+unsigned long long graphFingerprint(const CsrGraph<Location>& csr) {
+    unsigned long long hash = 14695981039346656037ULL;
+    mix(hash, csr.getNumVertex());
+    mix(hash, csr.getNumEdges());
+    for (unsigned v = 0; v < csr.getNumVertex(); v++) {
+        mix(hash, static_cast<unsigned long long>(csr.getInfo(v).id));
+    }
+    for (unsigned e = 0; e < csr.getNumEdges(); e++) {
+        double driving = csr.getDriving(e);
+        double walking = csr.getWalking(e);
+        unsigned long long bits;
+        mix(hash, csr.getSource(e));
+        mix(hash, csr.getTarget(e));
+        std::memcpy(&bits, &driving, sizeof(bits));
+        mix(hash, bits);
+        std::memcpy(&bits, &walking, sizeof(bits));
+        mix(hash, bits);
+    }
+    return hash;
+}
+
+/**
+ * @brief Selects the landmarks and fills the distance tables of both metrics.
+ *
+ * The first landmark is the vertex farthest from vertex 0. Every following one is the vertex whose
+ * distance to the closest landmark chosen so far is largest; vertices no landmark reaches come first,
+ * so that every component of the graph gets a landmark.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace used to run the searches; its bans are cleared.
+ * @param count Number of landmarks per metric.
+ */
+void LandmarkTable::build(const LoadedMap& map, SearchWorkspace& ws, unsigned count) {
+    const CsrGraph<Location>& csr = map.csr;
+    const std::unordered_set<int> noIgnore;
+    unsigned n = csr.getNumVertex();
+    count = std::min(count, n);
+
+    for (bool driving : {false, true}) {
+        std::vector<unsigned>& chosen = landmarks[driving];
+        chosen.clear();
+        from[driving].assign(static_cast<size_t>(n) * count, INF);
+        to[driving].assign(static_cast<size_t>(n) * count, INF);
+        if (count == 0) continue;
+
+        ws.reset();
+        std::vector<double> closest(n, INF);
+        std::vector<bool> isLandmark(n, false);
+
+        // Farthest vertex from an arbitrary start
+        dijkstra(map, ws, ws.forward, map.idOf(0), driving, false, noIgnore);
+        unsigned next = 0;
+        for (unsigned v = 0; v < n; v++) {
+            double d = ws.forward.getDist(v);
+            if (d != INF && d > ws.forward.getDist(next)) next = v;
+        }
+
+        for (unsigned k = 0; k < count; k++) {
+            chosen.push_back(next);
+            isLandmark[next] = true;
+            int id = map.idOf(next);
+            dijkstra(map, ws, ws.forward, id, driving, false, noIgnore);
+            reverseDijkstra(map, ws, ws.backward, id, driving, noIgnore);
+            for (unsigned v = 0; v < n; v++) {
+                from[driving][static_cast<size_t>(v) * count + k] = ws.forward.getDist(v);
+                to[driving][static_cast<size_t>(v) * count + k] = ws.backward.getDist(v);
+                closest[v] = std::min(closest[v], ws.forward.getDist(v));
+            }
+
+            bool found = false;
+            for (unsigned v = 0; v < n; v++) {
+                if (isLandmark[v]) continue;
+                if (!found || closest[v] > closest[next]) {
+                    next = v;
+                    found = true;
+                }
+            }
+            if (!found) break;
+        }
+    }
+}
+
+/**
+ * @brief Writes the tables to a binary file.
+ *
+ * Layout: magic, fingerprint, vertex count, and for each metric the number of landmarks,
+ * the landmark indices and both distance tables.
+ *
+ * @param path Path of the file.
+ * @param csr Graph the tables were computed for.
+ * @return True if the file was written.
+ */
+bool LandmarkTable::save(const std::string& path, const CsrGraph<Location>& csr) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    unsigned long long fingerprint = graphFingerprint(csr);
+    unsigned n = csr.getNumVertex();
+    file.write(LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC));
+    file.write(reinterpret_cast<const char*>(&fingerprint), sizeof(fingerprint));
+    file.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    for (int m = 0; m < 2; m++) {
+        unsigned k = landmarks[m].size();
+        file.write(reinterpret_cast<const char*>(&k), sizeof(k));
+        file.write(reinterpret_cast<const char*>(landmarks[m].data()), k * sizeof(unsigned));
+        file.write(reinterpret_cast<const char*>(from[m].data()), from[m].size() * sizeof(double));
+        file.write(reinterpret_cast<const char*>(to[m].data()), to[m].size() * sizeof(double));
+    }
+    return file.good();
+}
+
+/**
+ * @brief Reads the tables from a binary file, rejecting files written for another graph.
+ *
+ * @param path Path of the file.
+ * @param csr Graph the tables must belong to.
+ * @param count Number of landmarks expected per metric.
+ * @return True if the tables were loaded.
+ */
+bool LandmarkTable::load(const std::string& path, const CsrGraph<Location>& csr, unsigned count) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[sizeof(LANDMARK_MAGIC)];
+    unsigned long long fingerprint;
+    unsigned n;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+    file.read(reinterpret_cast<char*>(&n), sizeof(n));
+    if (!file || std::memcmp(magic, LANDMARK_MAGIC, sizeof(magic)) != 0) return false;
+    if (n != csr.getNumVertex() || fingerprint != graphFingerprint(csr)) return false;
+
+    std::vector<unsigned> readLandmarks[2];
+    std::vector<double> readFrom[2], readTo[2];
+    for (int m = 0; m < 2; m++) {
+        unsigned k;
+        file.read(reinterpret_cast<char*>(&k), sizeof(k));
+        if (!file || k != std::min(count, n)) return false;
+        readLandmarks[m].resize(k);
+        readFrom[m].resize(static_cast<size_t>(n) * k);
+        readTo[m].resize(static_cast<size_t>(n) * k);
+        file.read(reinterpret_cast<char*>(readLandmarks[m].data()), k * sizeof(unsigned));
+        file.read(reinterpret_cast<char*>(readFrom[m].data()), readFrom[m].size() * sizeof(double));
+        file.read(reinterpret_cast<char*>(readTo[m].data()), readTo[m].size() * sizeof(double));
+        if (!file) return false;
+    }
+
+    for (int m = 0; m < 2; m++) {
+        landmarks[m].swap(readLandmarks[m]);
+        from[m].swap(readFrom[m]);
+        to[m].swap(readTo[m]);
+    }
+    return true;
+}
+
+/**
+ * @brief Lower bound on d(v, t) from the triangle inequality over every landmark.
+ *
+ * Terms involving an unreachable landmark carry no information and are skipped.
+ *
+ * @param driving True for driving times; false for walking times.
+ * @param v Dense index of the start vertex.
+ * @param t Dense index of the target vertex.
+ * @return Largest lower bound, or 0.
+ */
+double LandmarkTable::lowerBound(bool driving, unsigned v, unsigned t) const {
+    size_t k = landmarks[driving].size();
+    const double* fromV = from[driving].data() + v * k;
+    const double* fromT = from[driving].data() + t * k;
+    const double* toV = to[driving].data() + v * k;
+    const double* toT = to[driving].data() + t * k;
+
+    double best = 0;
+    for (size_t i = 0; i < k; i++) {
+        if (fromT[i] != INF && fromV[i] != INF) best = std::max(best, fromT[i] - fromV[i]);
+        if (toV[i] != INF && toT[i] != INF) best = std::max(best, toV[i] - toT[i]);
+    }
+    return best;
+}
+
+/**
+ * @brief Loads the landmark tables of the map from disk, or computes and stores them if the file is missing or stale.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace used to run the preprocessing searches.
+ * @param path Path of the landmark file.
+ * @param count Number of landmarks per metric.
+ */
+void prepareLandmarks(LoadedMap& map, SearchWorkspace& ws, const std::string& path, unsigned count) {
+    if (map.landmarks.load(path, map.csr, count)) return;
+
+    map.landmarks.build(map, ws, count);
+    if (!map.landmarks.save(path, map.csr)) {
+        std::cerr << "Warning: could not write " << path << std::endl;
+    }
+}
@@ -0,0 +1,316 @@
+/**
+ * @file mapFile.cpp
+ * @brief Implements the binary map file written from the CSV files and memory-mapped at startup.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include "../include/MapFile.h"
+
+static const char MAP_MAGIC[8] = {'M', 'G', 'P', 'S', 'M', 'A', 'P', 0};
+
+// Written as is; reads back as another value on a machine with the other byte order
+#define MAP_BYTE_ORDER 0x01020304u
+
+// Sections start on a cache line boundary, which also aligns every array for its element type
+#define MAP_SECTION_ALIGN 64
+
+// Number of data files a map file can be stamped with
+#define MAP_MAX_SOURCES 4
+
+namespace {
+
+enum Section {
+    VERTICES, STRINGS, OFFSETS, SOURCES, TARGETS, DRIVING, WALKING, REVERSE, IN_OFFSETS, IN_EDGES, IDS, CODES,
+    NUM_SECTIONS
+};
+
+/**
+ * @brief Fixed-size header at the start of a map file.
+ */
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t numSources;
+    uint64_t sourceSize[MAP_MAX_SOURCES];           ///< Size of each data file, or ~0 if it did not exist.
+    int64_t sourceTime[MAP_MAX_SOURCES];            ///< Modification time of each data file, in file clock ticks.
+    uint32_t numVertex;
+    uint32_t numEdges;
+    uint32_t integralWeights[2];
+    uint32_t maxWeight[2];
+    double maxDrivingSpeed;
+    double maxWalkingSpeed;
+    uint64_t sectionOffset[NUM_SECTIONS];
+    uint64_t sectionSize[NUM_SECTIONS];
+};
+
+/**
+ * @brief Entry of the vertex table.
+ */
+struct VertexRecord {
+    int32_t id;
+    int32_t parking;
+    uint32_t name, nameLength;      ///< Position of the name in the string pool.
+    uint32_t code, codeLength;      ///< Position of the code in the string pool.
+    uint32_t hasCoordinates;
+    uint32_t unused;
+    double latitude;
+    double longitude;
+};
+
+/**
+ * @brief Records the size and modification time of the data files in a header.
+ *
+ * @return False if there are more files than the header has room for.
+ */
+bool stampSources(Header& header, const std::vector<std::string>& sources) {
+    if (sources.size() > MAP_MAX_SOURCES) return false;
+    header.numSources = sources.size();
+    for (size_t i = 0; i < sources.size(); i++) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(sources[i], error);
+        auto time = std::filesystem::last_write_time(sources[i], error);
+        header.sourceSize[i] = error ? std::numeric_limits<uint64_t>::max() : size;
+        header.sourceTime[i] = error ? 0 : time.time_since_epoch().count();
+    }
+    return true;
+}
+
+/**
+ * @brief Rounds a file position up to the next section boundary.
+ */
+uint64_t alignSection(uint64_t position) {
+    return (position + MAP_SECTION_ALIGN - 1) / MAP_SECTION_ALIGN * MAP_SECTION_ALIGN;
+}
+
+/**
+ * @brief Returns a typed pointer to a section, checking that it lies within the file and holds count elements.
+ */
+template <class Element>
+const Element* section(const MappedFile& file, const Header& header, Section s, uint64_t count) {
+    uint64_t offset = header.sectionOffset[s];
+    uint64_t size = header.sectionSize[s];
+    if (size != count * sizeof(Element) || offset % MAP_SECTION_ALIGN != 0 || offset > file.size() ||
+        size > file.size() - offset) {
+        return nullptr;
+    }
+    return reinterpret_cast<const Element*>(file.begin() + offset);
+}
+
+/**
+ * @brief Checks that the CSR arrays and indices of a map file describe a well-formed graph of the given locations.
+ *
+ * The routing code relies on every property checked here:
+ * - both offset arrays start at 0 and never decrease;
+ * - every edge is listed under its source, leads to a vertex and has non-negative weights (INF included, NaN not);
+ * - a reverse edge goes from the target of its edge back to its source;
+ * - every incoming edge is an edge, listed under its target;
+ * - the ID index lists every vertex once, sorted by ID, each entry holding the ID of its vertex;
+ * - the code index lists every vertex once, sorted by code.
+ *
+ * @note **Time Complexity:** O(N + M), plus the length of the codes.
+ */
+bool checkArrays(const CsrGraph<Location>::Arrays& arrays, const LocationId* ids, const unsigned* codes,
+                 const std::vector<Location>& locations, uint64_t m) {
+    uint64_t n = locations.size();
+    if (arrays.offsets[0] != 0 || arrays.inOffsets[0] != 0) return false;
+    std::vector<bool> hasId(n, false), hasCode(n, false);
+    for (uint64_t v = 0; v < n; v++) {
+        if (arrays.offsets[v] > arrays.offsets[v + 1] || arrays.inOffsets[v] > arrays.inOffsets[v + 1]) return false;
+        for (uint64_t e = arrays.offsets[v]; e < arrays.offsets[v + 1]; e++) {
+            unsigned r = arrays.reverse[e];
+            if (arrays.sources[e] != v || arrays.targets[e] >= n || !(arrays.driving[e] >= 0) ||
+                !(arrays.walking[e] >= 0) ||
+                (r != NO_EDGE && (r >= m || arrays.sources[r] != arrays.targets[e] || arrays.targets[r] != v))) {
+                return false;
+            }
+        }
+        for (uint64_t i = arrays.inOffsets[v]; i < arrays.inOffsets[v + 1]; i++) {
+            if (arrays.inEdges[i] >= m || arrays.targets[arrays.inEdges[i]] != v) return false;
+        }
+
+        unsigned idVertex = ids[v].index, codeVertex = codes[v];
+        if (idVertex >= n || hasId[idVertex] || ids[v].id != locations[idVertex].id ||
+            (v > 0 && ids[v - 1].id > ids[v].id)) {
+            return false;
+        }
+        if (codeVertex >= n || hasCode[codeVertex] || (v > 0 && locations[codes[v - 1]].code > locations[codeVertex].code)) {
+            return false;
+        }
+        hasId[idVertex] = hasCode[codeVertex] = true;
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Writes the header and then each section, padded to a section boundary.
+ */
+bool saveMapFile(const LoadedMap& map, const std::string& path, const std::vector<std::string>& sources) {
+    const CsrGraph<Location>& csr = map.csr;
+    uint64_t n = csr.getNumVertex();
+    uint64_t m = csr.getNumEdges();
+
+    Header header{};
+    std::memcpy(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+    header.version = MAP_FILE_VERSION;
+    header.byteOrder = MAP_BYTE_ORDER;
+    if (!stampSources(header, sources)) return false;
+    header.numVertex = static_cast<uint32_t>(n);
+    header.numEdges = static_cast<uint32_t>(m);
+    for (int driving = 0; driving < 2; driving++) {
+        header.integralWeights[driving] = map.integralWeights[driving];
+        header.maxWeight[driving] = map.maxWeight[driving];
+    }
+    header.maxDrivingSpeed = map.maxDrivingSpeed;
+    header.maxWalkingSpeed = map.maxWalkingSpeed;
+
+    std::vector<VertexRecord> vertices(n);
+    std::string strings;
+    for (unsigned v = 0; v < n; v++) {
+        const Location& location = csr.getInfo(v);
+        VertexRecord& record = vertices[v];
+        record.id = location.id;
+        record.parking = location.parking;
+        record.name = static_cast<uint32_t>(strings.size());
+        record.nameLength = static_cast<uint32_t>(location.name.size());
+        strings += location.name;
+        record.code = static_cast<uint32_t>(strings.size());
+        record.codeLength = static_cast<uint32_t>(location.code.size());
+        strings += location.code;
+        record.hasCoordinates = location.hasCoordinates;
+        record.latitude = location.latitude;
+        record.longitude = location.longitude;
+    }
+    if (strings.size() > std::numeric_limits<uint32_t>::max()) return false;
+
+    CsrGraph<Location>::Arrays arrays = csr.arrays();
+    const void* data[NUM_SECTIONS] = {
+        vertices.data(), strings.data(), arrays.offsets, arrays.sources, arrays.targets, arrays.driving,
+        arrays.walking, arrays.reverse, arrays.inOffsets, arrays.inEdges, map.ids.data(), map.codes.data()
+    };
+    header.sectionSize[VERTICES] = n * sizeof(VertexRecord);
+    header.sectionSize[STRINGS] = strings.size();
+    header.sectionSize[OFFSETS] = header.sectionSize[IN_OFFSETS] = (n + 1) * sizeof(unsigned);
+    header.sectionSize[SOURCES] = header.sectionSize[TARGETS] = header.sectionSize[REVERSE] =
+        header.sectionSize[IN_EDGES] = m * sizeof(unsigned);
+    header.sectionSize[DRIVING] = header.sectionSize[WALKING] = m * sizeof(double);
+    header.sectionSize[IDS] = map.ids.size() * sizeof(LocationId);
+    header.sectionSize[CODES] = map.codes.size() * sizeof(unsigned);
+    uint64_t position = alignSection(sizeof(Header));
+    for (int s = 0; s < NUM_SECTIONS; s++) {
+        header.sectionOffset[s] = position;
+        position = alignSection(position + header.sectionSize[s]);
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+        static const char padding[MAP_SECTION_ALIGN] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t written = sizeof(header);
+        for (int s = 0; s < NUM_SECTIONS; s++) {
+            file.write(padding, static_cast<std::streamsize>(header.sectionOffset[s] - written));
+            file.write(static_cast<const char*>(data[s]), static_cast<std::streamsize>(header.sectionSize[s]));
+            written = header.sectionOffset[s] + header.sectionSize[s];
+        }
+        if (!file.good()) return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) std::filesystem::remove(temporary, error);
+    return !error;
+}
+
+/**
+ * @brief Validates the header, every section and the graph arrays before changing the map, then attaches the map
+ * to the file and checks the recorded weight and speed bounds against the edges.
+ */
+bool loadMapFile(LoadedMap& map, const std::string& path, const std::vector<std::string>& sources) {
+    MappedFile& file = map.file;
+    if (!file.open(path, false)) return false;
+
+    Header header;
+    Header current{};
+    bool valid = file.size() >= sizeof(Header);
+    if (valid) {
+        std::memcpy(&header, file.begin(), sizeof(Header));
+        valid = std::memcmp(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC)) == 0 && header.version == MAP_FILE_VERSION &&
+                header.byteOrder == MAP_BYTE_ORDER && stampSources(current, sources) &&
+                header.numSources == current.numSources &&
+                std::memcmp(header.sourceSize, current.sourceSize, sizeof(current.sourceSize)) == 0 &&
+                std::memcmp(header.sourceTime, current.sourceTime, sizeof(current.sourceTime)) == 0;
+    }
+    uint64_t n = valid ? header.numVertex : 0;
+    uint64_t m = valid ? header.numEdges : 0;
+
+    const VertexRecord* vertices = valid ? section<VertexRecord>(file, header, VERTICES, n) : nullptr;
+    const char* strings = valid ? section<char>(file, header, STRINGS, header.sectionSize[STRINGS]) : nullptr;
+    CsrGraph<Location>::Arrays arrays{};
+    const LocationId* ids = nullptr;
+    const unsigned* codes = nullptr;
+    if (vertices && strings) {
+        arrays.offsets = section<unsigned>(file, header, OFFSETS, n + 1);
+        arrays.sources = section<unsigned>(file, header, SOURCES, m);
+        arrays.targets = section<unsigned>(file, header, TARGETS, m);
+        arrays.driving = section<double>(file, header, DRIVING, m);
+        arrays.walking = section<double>(file, header, WALKING, m);
+        arrays.reverse = section<unsigned>(file, header, REVERSE, m);
+        arrays.inOffsets = section<unsigned>(file, header, IN_OFFSETS, n + 1);
+        arrays.inEdges = section<unsigned>(file, header, IN_EDGES, m);
+        ids = section<LocationId>(file, header, IDS, n);
+        codes = section<unsigned>(file, header, CODES, n);
+    }
+    valid = ids && codes && arrays.offsets && arrays.sources && arrays.targets && arrays.driving &&
+            arrays.walking && arrays.reverse && arrays.inOffsets && arrays.inEdges &&
+            arrays.offsets[n] == m && arrays.inOffsets[n] == m;
+
+    std::vector<Location> locations;
+    if (valid) {
+        uint64_t poolSize = header.sectionSize[STRINGS];
+        locations.reserve(n);
+        for (uint64_t v = 0; v < n && valid; v++) {
+            const VertexRecord& record = vertices[v];
+            valid = uint64_t(record.name) + record.nameLength <= poolSize && uint64_t(record.code) + record.codeLength <= poolSize;
+            if (!valid) break;
+            locations.emplace_back(std::string(strings + record.name, record.nameLength), record.id,
+                                   std::string(strings + record.code, record.codeLength), record.parking);
+            if (record.hasCoordinates) locations.back().setCoordinates(record.latitude, record.longitude);
+        }
+    }
+    valid = valid && checkArrays(arrays, ids, codes, locations, m);
+    if (!valid) {
+        file.close();
+        return false;
+    }
+
+    map.csr.attach(std::move(locations), arrays);
+    map.ids.attach(ids, n);
+    map.codes.attach(codes, n);
+
+    // The weight and speed bounds pick the queue and the heuristics, so they are derived again rather than trusted
+    detectIntegralWeights(map);
+    computeSpeedBounds(map);
+    for (int driving = 0; driving < 2; driving++) {
+        valid = valid && map.integralWeights[driving] == (header.integralWeights[driving] != 0) &&
+                map.maxWeight[driving] == header.maxWeight[driving];
+    }
+    valid = valid && map.maxDrivingSpeed == header.maxDrivingSpeed && map.maxWalkingSpeed == header.maxWalkingSpeed;
+    if (!valid) {
+        map.csr = CsrGraph<Location>();
+        map.ids = FrozenArray<LocationId>();
+        map.codes = FrozenArray<unsigned>();
+        map.integralWeights[0] = map.integralWeights[1] = false;
+        map.maxWeight[0] = map.maxWeight[1] = 0;
+        map.maxDrivingSpeed = map.maxWalkingSpeed = 0;
+        file.close();
+    }
+    return valid;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file mappedFile.cpp
+ * @brief Implementation of the read-only file mapping used by the data loaders.
+ */
+
+#include <fstream>
+#include "../include/MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MYGPS_HAVE_MMAP 1
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data = other.data;
+        length = other.length;
+        opened = other.opened;
+        mapped = other.mapped;
+        buffer = std::move(other.buffer);   // a moved vector keeps its storage, so data stays valid
+        other.data = nullptr;
+        other.length = 0;
+        other.opened = false;
+        other.mapped = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path, bool sequential) {
+    close();
+
+#ifdef MYGPS_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        length = static_cast<std::size_t>(info.st_size);
+        if (length == 0) {
+            ::close(fd);
+            opened = true;
+            return true;
+        }
+        void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (address != MAP_FAILED) {
+            ::close(fd);    // the mapping stays valid after the descriptor is closed
+            if (sequential) madvise(address, length, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(address);
+            mapped = true;
+            opened = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // No mapping available: read the whole file into memory
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    buffer.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    data = buffer.data();
+    length = buffer.size();
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef MYGPS_HAVE_MMAP
+    if (mapped) munmap(const_cast<char*>(data), length);
+#endif
+    buffer.clear();
+    data = nullptr;
+    length = 0;
+    mapped = false;
+    opened = false;
+}
@@ -15,30 +15,31 @@
  *
  * The route can exclude certain nodes and segments and optionally include a required node.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @param origin ID of the starting location.
  * @param destination ID of the target location.
  * @param ignoreVertex Set of node IDs to avoid.
  * @param avoidSegments List of directed edges to avoid (pairs of node IDs).
  * @param include Node ID that must be included in the path (-1 if none).
+ * @param algorithm Search algorithm used for each origin-destination search.
  * @return A RestrictedRoutesResult containing the best path found and related info.
  */
-RestrictedRoutesResult excludeNodesOrSegments(int origin, int destination,
+RestrictedRoutesResult excludeNodesOrSegments(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination,
                                              const std::unordered_set<int>& ignoreVertex,
                                              const std::vector<std::pair<int, int>>& avoidSegments,
-                                             int include) {
-    Graph<Location> cityGraph;
-    createMap(cityGraph);
-
+                                             int include,
+                                             SearchAlgorithm algorithm) {
     RestrictedRoutesResult result;
 
-    if (idmap.find(origin) == idmap.end()) {
+    if (!map.contains(origin)) {
         result.origExists = false;
     }
-    if ( idmap.find(destination) == idmap.end()) {
+    if (!map.contains(destination)) {
         result.destExists = false;
     }
 
-    if (idmap.find(include) == idmap.end() && include!=-1) {
+    if (!map.contains(include) && include!=-1) {
         result.includeExists = false;
     }
 
@@ -46,21 +47,20 @@ RestrictedRoutesResult excludeNodesOrSegments(int origin, int destination,
         return result;
     }
 
+    ws.reset();
+
     // Ignore custom segments from 'avoidSegments'
     for (auto &seg : avoidSegments) {
         int fromID = seg.first;
         int toID = seg.second;
 
-        Vertex<Location>* fromV = nullptr;
-        if (idmap.find(fromID) != idmap.end()) {
-            fromV = idmap[fromID];
-        }
-        if (!fromV) continue; // Skip if the vertex is not found
+        int fromIdx = map.indexOf(fromID);
+        if (fromIdx == -1) continue; // Skip if the vertex is not found
 
-        // Mark the edge (fromID -> toID) as ignored
-        for (auto e : fromV->getAdj()) {
-            if (e->getDest()->getInfo().id == toID) {
-                e->setIgnored(true);
+        // Ban the edge (fromID -> toID) for this query
+        for (unsigned e : map.csr.edges(fromIdx)) {
+            if (map.idOf(map.csr.getTarget(e)) == toID) {
+                ws.banEdge(e);
             }
         }
     }
@@ -68,8 +68,8 @@ RestrictedRoutesResult excludeNodesOrSegments(int origin, int destination,
     // Case 1: Standard Restricted Route (No Include)
     if (include == -1) {
         result.bestTime = 0.0;
-        dijkstra(&cityGraph, origin, false, false, ignoreVertex);
-        result.bestPath = getBestPath(&cityGraph, origin, destination, result.bestTime);
+        shortestPath(map, ws, origin, destination, false, ignoreVertex, algorithm);
+        result.bestPath = getBestPath(map, ws, origin, destination, result.bestTime);
 
         result.pathFound = !result.bestPath.empty();
         return result;
@@ -83,8 +83,8 @@ RestrictedRoutesResult excludeNodesOrSegments(int origin, int destination,
     double timeToInclude = 0.0, timeFromInclude = 0.0;
 
     // Step 1: Compute origin → include
-    dijkstra(&cityGraph, origin, false, false, ignoreVertex);
-    pathToInclude = getBestPath(&cityGraph, origin, include, timeToInclude);
+    shortestPath(map, ws, origin, include, false, ignoreVertex, algorithm);
+    pathToInclude = getBestPath(map, ws, origin, include, timeToInclude);
 
     if (pathToInclude.empty()) {
         result.pathFound = false;
@@ -92,8 +92,8 @@ RestrictedRoutesResult excludeNodesOrSegments(int origin, int destination,
     }
 
     // Step 2: Compute include → destination
-    dijkstra(&cityGraph, include, false, false, ignoreVertex);
-    pathFromInclude = getBestPath(&cityGraph, include, destination, timeFromInclude);
+    shortestPath(map, ws, include, destination, false, ignoreVertex, algorithm);
+    pathFromInclude = getBestPath(map, ws, include, destination, timeFromInclude);
 
     if (pathFromInclude.empty()) {
         result.pathFound = false;
@@ -3,108 +3,877 @@
  * @brief Utility functions used in route planning algorithms, including Dijkstra and path reconstruction.
  */
 
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <type_traits>
 #include "../include/RoutePlanningUtils.h"
 
+/**
+ * @brief Parses the name of a search algorithm.
+ *
+ * @param name Name to parse ("dijkstra", "bidirectional", "astar", "alt", "ch" or "cch", case-insensitive).
+ * @param algorithm Receives the parsed algorithm.
+ * @return True if the name is valid.
+ */
+bool parseSearchAlgorithm(const std::string& name, SearchAlgorithm& algorithm) {
+    std::string lower;
+    for (char c : name) lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    if (lower == "dijkstra") {
+        algorithm = SearchAlgorithm::Dijkstra;
+    } else if (lower == "bidirectional") {
+        algorithm = SearchAlgorithm::Bidirectional;
+    } else if (lower == "astar" || lower == "a*") {
+        algorithm = SearchAlgorithm::AStar;
+    } else if (lower == "alt") {
+        algorithm = SearchAlgorithm::ALT;
+    } else if (lower == "ch") {
+        algorithm = SearchAlgorithm::CH;
+    } else if (lower == "cch") {
+        algorithm = SearchAlgorithm::CCH;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Relaxes an edge in the graph during Dijkstra's algorithm.
  *
  * This checks if the distance to the destination vertex can be improved by going through the current edge.
  * It also considers whether the edge should be ignored (due to restrictions or cost).
  *
- * @param edge Pointer to the edge to be relaxed.
+ * @param csr CSR snapshot of the graph.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree being built.
+ * @param edge CSR index of the edge to be relaxed.
  * @param driving True if using driving cost; false if using walking cost.
  * @param reverseNeeded True if the reverse edge should be used for path reconstruction.
- * @param ignoreVertex Set of node IDs that must be ignored.
  * @return True if the relaxation was successful and the destination distance was updated.
  */
-bool relax(Edge<Location>* edge, bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex) {
-    if (edge->getIgnored()) return false;
-    int destID = edge->getDest()->getInfo().id;
-    if (ignoreVertex.find(destID) != ignoreVertex.end()) return false;
+bool relax(const CsrGraph<Location>& csr, const SearchWorkspace& ws, SearchTree& tree, unsigned edge, bool driving, bool reverseNeeded) {
+    if (ws.isEdgeBanned(edge)) return false;
+    unsigned destIdx = csr.getTarget(edge);
+    if (ws.isVertexIgnored(destIdx)) return false;
 
-    Vertex<Location>* orig = edge->getOrig();
-    Vertex<Location>* dest = edge->getDest();
-
-    double cost = driving ? edge->getDriving() : edge->getWalking();
+    double cost = driving ? csr.getDriving(edge) : csr.getWalking(edge);
     if (cost == INF) return false;
 
-    double newDist = orig->getDist() + cost;
-    if (newDist < dest->getDist()) {
-        dest->setDist(newDist);
+    double newDist = tree.getDist(csr.getSource(edge)) + cost;
+    SearchTree::Node& dest = tree.touch(destIdx);
+    if (newDist < dest.dist) {
+        dest.dist = newDist;
         if (!driving && reverseNeeded) {
-            dest->setPath(edge->getReverse());
+            dest.path = csr.getReverse(edge);
         } else {
-            dest->setPath(edge);
+            dest.path = edge;
         }
         return true;
     }
     return false;
 }
 
+/**
+ * @brief Adapter giving the tree's MutablePriorityQueue the index-based interface of the other queues.
+ */
+class NodeQueue {
+public:
+    explicit NodeQueue(SearchTree& tree): tree(tree) {}
+
+    bool empty() {
+        return tree.queue.empty();
+    }
+
+    void insert(unsigned v, double key) {
+        SearchTree::Node& node = tree.touch(v);
+        node.key = key;
+        tree.queue.insert(&node);
+    }
+
+    void decreaseKey(unsigned v, double key) {
+        SearchTree::Node& node = tree.touch(v);
+        node.key = key;
+        tree.queue.decreaseKey(&node);
+    }
+
+    unsigned extractMin() {
+        return tree.indexOf(tree.queue.extractMin());
+    }
+
+private:
+    SearchTree& tree;
+};
+
+/**
+ * @brief Adapter running a search on one of the tree's (key, index) heaps, keeping the node keys up to date.
+ *
+ * @tparam Heap DaryHeap or PairingHeap.
+ */
+template <class Heap>
+class IndexQueue {
+public:
+    IndexQueue(SearchTree& tree, Heap& heap): tree(tree), heap(heap) {
+        heap.resize(tree.size());
+    }
+
+    bool empty() {
+        return heap.empty();
+    }
+
+    void insert(unsigned v, double key) {
+        tree.touch(v).key = key;
+        heap.insert(v, key);
+    }
+
+    void decreaseKey(unsigned v, double key) {
+        tree.touch(v).key = key;
+        heap.decreaseKey(v, key);
+    }
+
+    unsigned extractMin() {
+        return heap.extractMin();
+    }
+
+private:
+    SearchTree& tree;
+    Heap& heap;
+};
+
+/**
+ * @brief Adapter running a plain Dijkstra search on the tree's bucket queue; keys must be whole numbers.
+ */
+class BucketAdapter {
+public:
+    BucketAdapter(SearchTree& tree, unsigned maxWeight): tree(tree), buckets(tree.bucketQueue) {
+        buckets.resize(tree.size(), maxWeight);
+    }
+
+    bool empty() {
+        return buckets.empty();
+    }
+
+    void insert(unsigned v, double key) {
+        tree.touch(v).key = key;
+        buckets.insert(v, static_cast<BucketQueue::Key>(key));
+    }
+
+    void decreaseKey(unsigned v, double key) {
+        tree.touch(v).key = key;
+        buckets.decreaseKey(v, static_cast<BucketQueue::Key>(key));
+    }
+
+    unsigned extractMin() {
+        return buckets.extractMin();
+    }
+
+private:
+    SearchTree& tree;
+    BucketQueue& buckets;
+};
+
+/**
+ * @brief Queue without decrease-key: an improved vertex gets a new entry, and entries whose key no longer
+ * matches the vertex's key are skipped when they reach the top.
+ */
+class LazyQueue {
+public:
+    LazyQueue(SearchTree& tree, SearchStats& stats): tree(tree), heap(tree.lazyHeap), stats(stats) {}
+
+    bool empty() {
+        while (!heap.empty() && heap.front().first != tree.touch(heap.front().second).key) {
+            pop();
+            stats.stalePops++;
+        }
+        return heap.empty();
+    }
+
+    void insert(unsigned v, double key) {
+        tree.touch(v).key = key;
+        heap.push_back({key, v});
+        std::push_heap(heap.begin(), heap.end(), later);
+    }
+
+    void decreaseKey(unsigned v, double key) {
+        insert(v, key);
+    }
+
+    unsigned extractMin() {
+        unsigned v = heap.front().second;
+        pop();
+        return v;
+    }
+
+private:
+    void pop() {
+        std::pop_heap(heap.begin(), heap.end(), later);
+        heap.pop_back();
+    }
+
+    SearchTree& tree;
+    std::vector<std::pair<double, unsigned>>& heap;
+    SearchStats& stats;
+    std::greater<std::pair<double, unsigned>> later;
+};
+
+/**
+ * @brief Potential of plain Dijkstra: no estimate of the remaining distance.
+ */
+struct NoPotential {
+    double operator()(unsigned) const {
+        return 0;
+    }
+};
+
+/**
+ * @brief Search loop shared by all the Dijkstra variants, over any queue with the NodeQueue interface.
+ *
+ * Counts the work done in ws.stats.
+ *
+ * @tparam Queue NodeQueue, IndexQueue, BucketAdapter or LazyQueue; empty() must be called before each extractMin().
+ * @tparam Potential Callable with signature double(unsigned vertex).
+ * @tparam Stop Callable with signature bool(unsigned vertex, double dist).
+ */
+template <class Queue, class Potential, class Stop>
+static void runSearch(const CsrGraph<Location>& csr, SearchWorkspace& ws, SearchTree& tree, unsigned s, bool driving,
+                      bool reverseNeeded, Queue pq, Potential potential, Stop stop) {
+    SearchStats& stats = ws.stats;
+    pq.insert(s, potential(s));
+    stats.inserts++;
+
+    while (!pq.empty()) {
+        unsigned v = pq.extractMin();
+        stats.settled++;
+        if (stop(v, tree.getDist(v))) break;
+
+        for (unsigned e : csr.edges(v)) {
+            if (csr.getDriving(e) != INF) {
+                unsigned w = csr.getTarget(e);
+                double oldDist = tree.getDist(w);
+                if (relax(csr, ws, tree, e, driving, reverseNeeded)) {
+                    double key = tree.getDist(w) + potential(w);
+                    if (oldDist == INF) {
+                        pq.insert(w, key);
+                        stats.inserts++;
+                    } else {
+                        pq.decreaseKey(w, key);
+                        stats.decreases++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Core of all the Dijkstra variants, and of A*.
+ *
+ * Starts a new search in the given tree and processes the CSR edges using the priority queue selected
+ * in the workspace (see QueueKind). The bucket queue is only used for plain Dijkstra over a metric whose
+ * weights are small integers; other searches fall back to the binary queue.
+ * Vertices are ordered by their distance plus @p potential, which must be a consistent lower bound on
+ * the remaining distance (a potential of 0 gives plain Dijkstra).
+ * After each extraction, @p stop is called with the settled vertex and its distance; if it returns true,
+ * the search ends before that vertex's edges are relaxed.
+ *
+ * @tparam Potential Callable with signature double(unsigned vertex).
+ * @tparam Stop Callable with signature bool(unsigned vertex, double dist).
+ */
+template <class Potential, class Stop>
+static void runDijkstra(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, int origin, bool driving, bool reverseNeeded,
+                        const std::unordered_set<int>& ignoreVertex, Potential potential, Stop stop) {
+    const CsrGraph<Location>& csr = map.csr;
+    tree.reset();
+    ws.setIgnoredVertices(map, ignoreVertex);
+
+    int s = map.indexOf(origin);
+    SearchTree::Node& sNode = tree.touch(s);
+    sNode.dist = 0;
+    sNode.key = potential(s);
+    if (ws.isVertexIgnored(s)) return;
+
+    switch (ws.getQueueKind()) {
+        case QueueKind::FourAry:
+            runSearch(csr, ws, tree, s, driving, reverseNeeded, IndexQueue<DaryHeap<4>>(tree, tree.fourAryHeap), potential, stop);
+            break;
+        case QueueKind::EightAry:
+            runSearch(csr, ws, tree, s, driving, reverseNeeded, IndexQueue<DaryHeap<8>>(tree, tree.eightAryHeap), potential, stop);
+            break;
+        case QueueKind::Pairing:
+            runSearch(csr, ws, tree, s, driving, reverseNeeded, IndexQueue<PairingHeap>(tree, tree.pairingHeap), potential, stop);
+            break;
+        case QueueKind::Lazy:
+            runSearch(csr, ws, tree, s, driving, reverseNeeded, LazyQueue(tree, ws.stats), potential, stop);
+            break;
+        case QueueKind::Bucket:
+            if (std::is_same<Potential, NoPotential>::value && map.hasIntegralWeights(driving)) {
+                runSearch(csr, ws, tree, s, driving, reverseNeeded, BucketAdapter(tree, map.maxWeight[driving]), potential, stop);
+                break;
+            }
+            // fall through
+        case QueueKind::Binary:
+        default:
+            runSearch(csr, ws, tree, s, driving, reverseNeeded, NodeQueue(tree), potential, stop);
+            break;
+    }
+}
+
 /**
  * @brief Runs Dijkstra's algorithm on the graph to calculate the shortest path from the origin.
  *
- * Initializes all vertices, and processes edges using a mutable priority queue.
- * Takes into account whether the user is driving or walking and which nodes should be ignored.
+ * Settles every reachable vertex. Takes into account whether the user is driving or walking
+ * and which nodes should be ignored. The map itself is left untouched.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the origin vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param reverseNeeded True if reverse edge information is needed (for walking paths).
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void dijkstra(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex) {
+    runDijkstra(map, ws, tree, origin, driving, reverseNeeded, ignoreVertex,
+                NoPotential(), [](unsigned, double) { return false; });
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm until the destination is settled.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the vertex whose path is needed.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void dijkstraToTarget(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+                      bool driving, const std::unordered_set<int>& ignoreVertex) {
+    unsigned t = map.indexOf(destination);
+    runDijkstra(map, ws, tree, origin, driving, false, ignoreVertex,
+                NoPotential(), [t](unsigned v, double) { return v == t; });
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm until every vertex of a target list is settled.
+ *
+ * Unknown target IDs are skipped. If some target is unreachable, the search runs to completion.
  *
- * @param g Pointer to the graph.
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
  * @param origin ID of the origin vertex.
+ * @param targets IDs of the vertices whose paths are needed.
  * @param driving True if using driving cost; false if using walking cost.
  * @param reverseNeeded True if reverse edge information is needed (for walking paths).
  * @param ignoreVertex Set of node IDs to be ignored during traversal.
  */
-void dijkstra(const Graph<Location>* g, const int& origin, bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex) {
-    for (auto v : g->getVertexSet()) {
-        v->setDist(INF);
-        v->setPath(nullptr);
+void dijkstraToTargets(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const std::vector<int>& targets,
+                       bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex) {
+    unsigned remaining = ws.setTargets(map, targets);
+    if (remaining == 0) {
+        tree.reset();
+        return;
     }
-    Vertex<Location>* s = idmap.at(origin);
-    s->setDist(0);
-    if (ignoreVertex.find(origin) != ignoreVertex.end()) return;
+    runDijkstra(map, ws, tree, origin, driving, reverseNeeded, ignoreVertex,
+                NoPotential(), [&ws, &remaining](unsigned v, double) { return ws.isTarget(v) && --remaining == 0; });
+}
 
-    MutablePriorityQueue<Vertex<Location>> pq;
-    pq.insert(s);
+/**
+ * @brief Runs Dijkstra's algorithm, settling only the vertices within a maximum distance of the origin.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the origin vertex.
+ * @param maxDist Largest distance of interest; vertices farther away are left unsettled.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param reverseNeeded True if reverse edge information is needed (for walking paths).
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void dijkstraWithin(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, double maxDist,
+                    bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex) {
+    runDijkstra(map, ws, tree, origin, driving, reverseNeeded, ignoreVertex,
+                NoPotential(), [maxDist](unsigned, double dist) { return dist > maxDist; });
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm past the destination, until every vertex within a stretch of its distance is settled.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param stretch The search settles the vertices up to (1 + stretch) times the distance of the destination.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void dijkstraWithinStretch(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+                           double stretch, bool driving, const std::unordered_set<int>& ignoreVertex) {
+    unsigned t = map.indexOf(destination);
+    double maxDist = INF;
+    runDijkstra(map, ws, tree, origin, driving, false, ignoreVertex, NoPotential(), [t, stretch, &maxDist](unsigned v, double dist) {
+        if (v == t) maxDist = dist * (1 + stretch);
+        return dist > maxDist;
+    });
+}
+
+/**
+ * @brief Runs an A* search from origin to destination, guided by the straight-line distance to the destination.
+ *
+ * The estimate of a vertex is its straight-line distance to the destination divided by the fastest speed
+ * of any edge of the metric, which never overestimates the remaining time, so the path found is optimal.
+ * Bans only make paths longer, so the estimate stays valid in restricted queries. When the map has no
+ * coordinates for this metric, plain Dijkstra is used instead.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void aStar(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+           bool driving, const std::unordered_set<int>& ignoreVertex) {
+    if (!map.hasSpeedBound(driving)) {
+        dijkstraToTarget(map, ws, tree, origin, destination, driving, ignoreVertex);
+        return;
+    }
+    const CsrGraph<Location>& csr = map.csr;
+    unsigned t = map.indexOf(destination);
+    const Location& target = csr.getInfo(t);
+    double speed = driving ? map.maxDrivingSpeed : map.maxWalkingSpeed;
+    runDijkstra(map, ws, tree, origin, driving, false, ignoreVertex,
+                [&csr, &target, speed](unsigned v) { return straightLineDistance(csr.getInfo(v), target) / speed; },
+                [t](unsigned v, double) { return v == t; });
+}
+
+/**
+ * @brief Runs an A* search from origin to destination, guided by the exact distances to the destination.
+ *
+ * Vertices that cannot reach the destination even without bans have an infinite estimate; once one of them is
+ * extracted, every vertex left in the queue is in the same case, so the search stops there.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param toDestination Tree of a complete reverse search from the destination, without bans.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void guidedSearch(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+                  const SearchTree& toDestination, bool driving, const std::unordered_set<int>& ignoreVertex) {
+    unsigned t = map.indexOf(destination);
+    runDijkstra(map, ws, tree, origin, driving, false, ignoreVertex,
+                [&toDestination](unsigned v) { return toDestination.getDist(v); },
+                [t, &toDestination](unsigned v, double) { return v == t || toDestination.getDist(v) == INF; });
+}
+
+/**
+ * @brief Relaxes an incoming edge during the backward half of a bidirectional search.
+ *
+ * The edge (u -> v) is followed against its direction: u is reached from v, and the edge itself
+ * is stored as u's path, pointing towards the destination.
+ *
+ * @param csr CSR snapshot of the graph.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Backward search tree.
+ * @param edge CSR index of the edge to be relaxed.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @return True if the distance of the edge's origin was updated.
+ */
+static bool relaxBackward(const CsrGraph<Location>& csr, const SearchWorkspace& ws, SearchTree& tree, unsigned edge, bool driving) {
+    if (ws.isEdgeBanned(edge)) return false;
+    unsigned origIdx = csr.getSource(edge);
+    if (ws.isVertexIgnored(origIdx)) return false;
+
+    double cost = driving ? csr.getDriving(edge) : csr.getWalking(edge);
+    if (cost == INF) return false;
+
+    double newDist = tree.getDist(csr.getTarget(edge)) + cost;
+    SearchTree::Node& orig = tree.touch(origIdx);
+    if (newDist < orig.dist) {
+        orig.dist = newDist;
+        orig.path = edge;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm on the reversed graph, computing the distance from every vertex to the origin.
+ *
+ * The path of each vertex is the outgoing edge that leads towards the origin.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the vertex the distances are measured to.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void reverseDijkstra(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, bool driving, const std::unordered_set<int>& ignoreVertex) {
+    reverseDijkstraWithin(map, ws, tree, origin, INF, driving, ignoreVertex);
+}
+
+/**
+ * @brief Runs Dijkstra's algorithm on the reversed graph, settling only the vertices within a maximum distance of the origin.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the vertex the distances are measured to.
+ * @param maxDist Largest distance of interest; vertices farther away are left unsettled.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ * @param forward Optional forward search tree; a vertex is then only expanded if its distance in it plus its
+ *        distance to the origin is at most maxDist.
+ */
+void reverseDijkstraWithin(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, double maxDist,
+                           bool driving, const std::unordered_set<int>& ignoreVertex, const SearchTree* forward) {
+    const CsrGraph<Location>& csr = map.csr;
+    tree.reset();
+    ws.setIgnoredVertices(map, ignoreVertex);
+
+    int t = map.indexOf(origin);
+    SearchTree::Node& tNode = tree.touch(t);
+    tNode.dist = tNode.key = 0;
+    if (ws.isVertexIgnored(t)) return;
+
+    MutablePriorityQueue<SearchTree::Node>& pq = tree.queue;
+    pq.insert(&tNode);
 
     while (!pq.empty()) {
-        Vertex<Location>* v = pq.extractMin();
-
-        for (auto e : v->getAdj()) {
-            if (e->getDriving() != INF && ignoreVertex.find(e->getDest()->getInfo().id) == ignoreVertex.end() && !e->getIgnored()) {
-                double oldDist = e->getDest()->getDist();
-                if (relax(e, driving, reverseNeeded, ignoreVertex)) {
-                    if (oldDist == INF) pq.insert(e->getDest());
-                    else pq.decreaseKey(e->getDest());
+        unsigned v = tree.indexOf(pq.extractMin());
+        if (tree.getDist(v) > maxDist) break;
+        if (forward != nullptr && forward->getDist(v) + tree.getDist(v) > maxDist) continue;
+        for (unsigned i : csr.incoming(v)) {
+            unsigned e = csr.getIncoming(i);
+            if (csr.getDriving(e) == INF) continue;
+            unsigned u = csr.getSource(e);
+            double oldDist = tree.getDist(u);
+            if (relaxBackward(csr, ws, tree, e, driving)) {
+                SearchTree::Node* node = &tree.touch(u);
+                node->key = node->dist;
+                if (oldDist == INF) pq.insert(node);
+                else pq.decreaseKey(node);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Runs an ALT search (A* with landmark lower bounds) from origin to destination.
+ *
+ * Falls back to plain Dijkstra when no landmark tables were prepared.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the distances and paths.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void altSearch(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+               bool driving, const std::unordered_set<int>& ignoreVertex) {
+    if (!map.landmarks.available(driving)) {
+        dijkstraToTarget(map, ws, tree, origin, destination, driving, ignoreVertex);
+        return;
+    }
+    const LandmarkTable& landmarks = map.landmarks;
+    unsigned t = map.indexOf(destination);
+    runDijkstra(map, ws, tree, origin, driving, false, ignoreVertex,
+                [&landmarks, driving, t](unsigned v) { return landmarks.lowerBound(driving, v, t); },
+                [t](unsigned v, double) { return v == t; });
+}
+
+/**
+ * @brief Runs a bidirectional Dijkstra search between origin and destination.
+ *
+ * Each side keeps its own tree and queue in the workspace. Whenever an edge is relaxed, the vertex it reaches
+ * is checked against the other tree to update the best meeting point. The search stops when the sum of the
+ * smallest keys of both queues can no longer improve on it. Finally, the backward path from the meeting point
+ * is copied into the forward tree, so the whole route can be read from ws.forward.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void bidirectionalDijkstra(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving, const std::unordered_set<int>& ignoreVertex) {
+    const CsrGraph<Location>& csr = map.csr;
+    SearchTree& fwd = ws.forward;
+    SearchTree& bwd = ws.backward;
+    fwd.reset();
+    bwd.reset();
+    ws.setIgnoredVertices(map, ignoreVertex);
+
+    int s = map.indexOf(origin);
+    int t = map.indexOf(destination);
+    fwd.touch(s).dist = fwd.touch(s).key = 0;
+    if (s == t || ws.isVertexIgnored(s) || ws.isVertexIgnored(t)) return;
+    bwd.touch(t).dist = bwd.touch(t).key = 0;
+
+    fwd.queue.insert(&fwd.touch(s));
+    bwd.queue.insert(&bwd.touch(t));
+
+    double best = INF;
+    int meet = -1;
+    while (!fwd.queue.empty() && !bwd.queue.empty()) {
+        double fwdMin = fwd.queue.top()->dist;
+        double bwdMin = bwd.queue.top()->dist;
+        if (fwdMin + bwdMin >= best) break;
+
+        if (fwdMin <= bwdMin) {
+            unsigned v = fwd.indexOf(fwd.queue.extractMin());
+            for (unsigned e : csr.edges(v)) {
+                if (csr.getDriving(e) == INF) continue;
+                unsigned w = csr.getTarget(e);
+                double oldDist = fwd.getDist(w);
+                if (relax(csr, ws, fwd, e, driving, false)) {
+                    fwd.touch(w).key = fwd.getDist(w);
+                    if (oldDist == INF) fwd.queue.insert(&fwd.touch(w));
+                    else fwd.queue.decreaseKey(&fwd.touch(w));
+                }
+                if (fwd.getDist(w) + bwd.getDist(w) < best) {
+                    best = fwd.getDist(w) + bwd.getDist(w);
+                    meet = w;
+                }
+            }
+        } else {
+            unsigned v = bwd.indexOf(bwd.queue.extractMin());
+            for (unsigned i : csr.incoming(v)) {
+                unsigned e = csr.getIncoming(i);
+                if (csr.getDriving(e) == INF) continue;
+                unsigned u = csr.getSource(e);
+                double oldDist = bwd.getDist(u);
+                if (relaxBackward(csr, ws, bwd, e, driving)) {
+                    bwd.touch(u).key = bwd.getDist(u);
+                    if (oldDist == INF) bwd.queue.insert(&bwd.touch(u));
+                    else bwd.queue.decreaseKey(&bwd.touch(u));
+                }
+                if (fwd.getDist(u) + bwd.getDist(u) < best) {
+                    best = fwd.getDist(u) + bwd.getDist(u);
+                    meet = u;
                 }
             }
         }
     }
+    if (meet == -1) return;
+
+    // Stitch the backward half (meet -> destination) into the forward tree
+    unsigned x = meet;
+    unsigned e;
+    while ((e = bwd.getPath(x)) != NO_EDGE) {
+        unsigned y = csr.getTarget(e);
+        SearchTree::Node& node = fwd.touch(y);
+        node.dist = fwd.getDist(x) + (driving ? csr.getDriving(e) : csr.getWalking(e));
+        node.path = e;
+        x = y;
+    }
+}
+
+/**
+ * @brief Stores a path given as CSR edges in the forward tree, as a plain search from its origin would.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace whose forward tree receives the path.
+ * @param s Dense index of the origin.
+ * @param found False if no path exists (only the origin is stored).
+ * @param edges CSR indices of the edges of the path, in order.
+ * @param driving True if using driving cost; false if using walking cost.
+ */
+static void layOutPath(const LoadedMap& map, SearchWorkspace& ws, unsigned s, bool found, const std::vector<unsigned>& edges, bool driving) {
+    const CsrGraph<Location>& csr = map.csr;
+    SearchTree& fwd = ws.forward;
+    fwd.reset();
+    fwd.touch(s).dist = 0;
+    if (!found) return;
+    for (unsigned e : edges) {
+        SearchTree::Node& node = fwd.touch(csr.getTarget(e));
+        node.dist = fwd.getDist(csr.getSource(e)) + (driving ? csr.getDriving(e) : csr.getWalking(e));
+        node.path = e;
+    }
+}
+
+/**
+ * @brief Computes the shortest path with the contraction hierarchy of the map and stores it in the forward tree.
+ *
+ * The hierarchy knows nothing about per-query bans, so when edges are banned or vertices are ignored,
+ * dijkstraToTarget is used instead. Otherwise the hierarchy of the metric is built if this is its first use.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void hierarchySearch(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                     const std::unordered_set<int>& ignoreVertex) {
+    if (ws.hasBannedEdges() || !ignoreVertex.empty()) {
+        dijkstraToTarget(map, ws, ws.forward, origin, destination, driving, ignoreVertex);
+        return;
+    }
+
+    const ContractionHierarchy& ch = map.contractionHierarchy(driving);
+    unsigned s = map.indexOf(origin);
+    std::vector<unsigned> edges;
+    double dist = ch.query(ws, s, map.indexOf(destination), edges);
+    layOutPath(map, ws, s, dist != INF, edges, driving);
+}
+
+/**
+ * @brief Looks the shortest path up in the all-pairs table of the map and stores it in the forward tree.
+ *
+ * The table knows nothing about per-query bans, so when edges are banned, vertices are ignored or the
+ * table was not prepared, dijkstraToTarget is used instead.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void tableSearch(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                 const std::unordered_set<int>& ignoreVertex) {
+    const AllPairsTable& table = map.allPairs;
+    if (table.empty() || ws.hasBannedEdges() || !ignoreVertex.empty()) {
+        dijkstraToTarget(map, ws, ws.forward, origin, destination, driving, ignoreVertex);
+        return;
+    }
+
+    unsigned s = map.indexOf(origin), t = map.indexOf(destination);
+    std::vector<unsigned> edges;
+    table.path(driving, s, t, map.csr, edges);
+    layOutPath(map, ws, s, table.getDist(driving, s, t) != INF, edges, driving);
+}
+
+/**
+ * @brief Runs an A* search from origin to destination, guided by the distances to the destination in the
+ * customizable hierarchy of the map.
+ *
+ * The distances ignore the bans, which can only make routes longer, so they are a consistent lower bound.
+ * Like guidedSearch, stops once a vertex that cannot reach the destination even without bans is extracted.
+ *
+ * @param map The loaded map; its customizable hierarchy is built if this is its first use.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ */
+void customizableSearch(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                        const std::unordered_set<int>& ignoreVertex) {
+    const CustomizableHierarchy& cch = map.customizableHierarchy();
+    unsigned t = map.indexOf(destination);
+    cch.searchTo(ws, t, driving);
+    runDijkstra(map, ws, ws.forward, origin, driving, false, ignoreVertex,
+                [&cch, &ws, driving](unsigned v) { return cch.potential(ws, v, driving); },
+                [&cch, &ws, t, driving](unsigned v, double) { return v == t || cch.potential(ws, v, driving) == INF; });
+}
+
+/**
+ * @brief Computes the shortest path between two vertices with the contraction hierarchy, ignoring any bans.
+ *
+ * @param map The loaded map; its hierarchy for the metric is built if this is its first use.
+ * @param ws Workspace whose search trees are used.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param time Reference to store the total driving time of the path.
+ * @return A vector of node IDs representing the path, or empty if no path exists.
+ */
+std::vector<int> hierarchyPath(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving, double& time) {
+    const CsrGraph<Location>& csr = map.csr;
+    std::vector<unsigned> edges;
+    unsigned s = map.indexOf(origin);
+    if (map.contractionHierarchy(driving).query(ws, s, map.indexOf(destination), edges) == INF) {
+        return {};
+    }
+
+    std::vector<int> res;
+    res.push_back(origin);
+    for (unsigned e : edges) {
+        time += csr.getDriving(e);
+        res.push_back(map.idOf(csr.getTarget(e)));
+    }
+    return res;
+}
+
+/**
+ * @brief Computes the shortest path between two vertices with the selected algorithm.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True if using driving cost; false if using walking cost.
+ * @param ignoreVertex Set of node IDs to be ignored during traversal.
+ * @param algorithm Search algorithm to use.
+ */
+void shortestPath(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                  const std::unordered_set<int>& ignoreVertex, SearchAlgorithm algorithm) {
+    switch (algorithm) {
+        case SearchAlgorithm::Bidirectional:
+            bidirectionalDijkstra(map, ws, origin, destination, driving, ignoreVertex);
+            break;
+        case SearchAlgorithm::AStar:
+            aStar(map, ws, ws.forward, origin, destination, driving, ignoreVertex);
+            break;
+        case SearchAlgorithm::ALT:
+            altSearch(map, ws, ws.forward, origin, destination, driving, ignoreVertex);
+            break;
+        case SearchAlgorithm::CH:
+            hierarchySearch(map, ws, origin, destination, driving, ignoreVertex);
+            break;
+        case SearchAlgorithm::CCH:
+            customizableSearch(map, ws, origin, destination, driving, ignoreVertex);
+            break;
+        case SearchAlgorithm::Dijkstra:
+        default:
+            tableSearch(map, ws, origin, destination, driving, ignoreVertex);
+            break;
+    }
 }
 
 /**
  * @brief Reconstructs the best path from origin to destination after running Dijkstra's algorithm.
  *
- * Traverses the `path` pointers backwards from the destination to build the route, calculates total time,
- * and marks each used edge as ignored for future alternative route calculations.
+ * Traverses the forward search tree backwards from the destination to build the route, calculates total time,
+ * and bans each used edge in the workspace for future alternative route calculations of the same query.
  *
- * @param g Pointer to the graph.
+ * @param map The loaded map.
+ * @param ws Workspace whose forward tree holds the result of the last search.
  * @param origin ID of the origin node.
  * @param dest ID of the destination node.
  * @param time Reference to store the total time of the best path.
  * @return A vector of node IDs representing the best path found, or empty if no path exists.
  */
-std::vector<int> getBestPath(Graph<Location>* g, const int& origin, const int& dest, double& time) {
-    Vertex<Location>* d = idmap[dest];
-    if (d->getDist() == INF) {
+std::vector<int> getBestPath(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& dest, double& time) {
+    const CsrGraph<Location>& csr = map.csr;
+    unsigned d = map.indexOf(dest);
+    if (ws.forward.getDist(d) == INF) {
         return {};
     }
 
     std::vector<int> res;
-    res.push_back(d->getInfo().id);
-    while (d->getPath() != nullptr) {
-        time += d->getPath()->getDriving();
-        d->getPath()->setIgnored(true);
-        d = d->getPath()->getOrig();
-        res.push_back(d->getInfo().id);
+    res.push_back(map.idOf(d));
+    unsigned path;
+    while ((path = ws.forward.getPath(d)) != NO_EDGE) {
+        time += csr.getDriving(path);
+        ws.banEdge(path);
+        d = csr.getSource(path);
+        res.push_back(map.idOf(d));
     }
     std::reverse(res.begin(), res.end());
     return res;
@@ -0,0 +1,168 @@
+/**
+ * @file SearchWorkspace.cpp
+ * @brief Implements the per-query search state used by the route planners.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include "../include/SearchWorkspace.h"
+
+/**
+ * @brief Parses the name of a priority queue kind.
+ *
+ * @param name Name to parse, case-insensitive.
+ * @param kind Receives the queue kind on success.
+ * @return True if the name was recognised.
+ */
+bool parseQueueKind(const std::string& name, QueueKind& kind) {
+    std::string lower;
+    for (char c : name) lower += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+    if (lower == "binary") {
+        kind = QueueKind::Binary;
+    } else if (lower == "4-ary") {
+        kind = QueueKind::FourAry;
+    } else if (lower == "8-ary") {
+        kind = QueueKind::EightAry;
+    } else if (lower == "pairing") {
+        kind = QueueKind::Pairing;
+    } else if (lower == "bucket") {
+        kind = QueueKind::Bucket;
+    } else if (lower == "lazy") {
+        kind = QueueKind::Lazy;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Name of a queue kind.
+ *
+ * @param kind Queue kind.
+ * @return Name accepted by parseQueueKind.
+ */
+const char* queueKindName(QueueKind kind) {
+    switch (kind) {
+        case QueueKind::FourAry: return "4-ary";
+        case QueueKind::EightAry: return "8-ary";
+        case QueueKind::Pairing: return "pairing";
+        case QueueKind::Bucket: return "bucket";
+        case QueueKind::Lazy: return "lazy";
+        case QueueKind::Binary:
+        default: return "binary";
+    }
+}
+
+/**
+ * @brief Resizes the tree so it can hold the state of every vertex.
+ *
+ * @param numVertices Number of vertices in the graph.
+ */
+void SearchTree::resize(size_t numVertices) {
+    nodes.assign(numVertices, Node());
+    touched.clear();
+    queue.clear();
+    fourAryHeap.clear();
+    eightAryHeap.clear();
+    pairingHeap.clear();
+    bucketQueue.clear();
+    lazyHeap.clear();
+    touched.reserve(numVertices);
+    epoch = 1;
+}
+
+/**
+ * @brief Invalidates the previous search by moving to a new epoch.
+ *
+ * Stamps are only cleared when the epoch counter wraps around. The touched list and the
+ * queue keep their capacity, so repeated searches do not allocate.
+ */
+void SearchTree::reset() {
+    touched.clear();
+    queue.clear();
+    fourAryHeap.clear();
+    eightAryHeap.clear();
+    pairingHeap.clear();
+    bucketQueue.clear();
+    lazyHeap.clear();
+    if (++epoch == 0) {
+        for (auto &n : nodes) n.stamp = 0;
+        epoch = 1;
+    }
+}
+
+/**
+ * @brief Creates a workspace with search trees sized for the given map.
+ *
+ * @param map The loaded map the workspace will be used with.
+ */
+SearchWorkspace::SearchWorkspace(const LoadedMap& map) {
+    size_t n = map.csr.getNumVertex();
+    forward.resize(n);
+    backward.resize(n);
+    bannedStamp.assign(map.csr.getNumEdges(), 0);
+    ignoredStamp.assign(n, 0);
+    targetStamp.assign(n, 0);
+}
+
+/**
+ * @brief Clears the bans of the previous query.
+ */
+void SearchWorkspace::reset() {
+    if (++bannedEpoch == 0) {
+        std::fill(bannedStamp.begin(), bannedStamp.end(), 0);
+        bannedEpoch = 1;
+    }
+    bannedEdges.clear();
+    clearIgnoredVertices();
+}
+
+/**
+ * @brief Forgets the ignored vertices by moving to a new epoch.
+ */
+void SearchWorkspace::clearIgnoredVertices() {
+    if (++ignoredEpoch == 0) {
+        std::fill(ignoredStamp.begin(), ignoredStamp.end(), 0);
+        ignoredEpoch = 1;
+    }
+}
+
+/**
+ * @brief Marks the given vertices as ignored for the next search.
+ *
+ * Unknown IDs are skipped.
+ *
+ * @param map The loaded map.
+ * @param ignoreVertex IDs of the vertices to avoid.
+ */
+void SearchWorkspace::setIgnoredVertices(const LoadedMap& map, const std::unordered_set<int>& ignoreVertex) {
+    clearIgnoredVertices();
+    for (int id : ignoreVertex) {
+        int index = map.indexOf(id);
+        if (index != -1) ignoredStamp[index] = ignoredEpoch;
+    }
+}
+
+/**
+ * @brief Marks the given vertices as targets of the next multi-target search.
+ *
+ * @param map The loaded map.
+ * @param targets IDs of the target vertices.
+ * @return Number of distinct known targets.
+ */
+unsigned SearchWorkspace::setTargets(const LoadedMap& map, const std::vector<int>& targets) {
+    if (++targetEpoch == 0) {
+        std::fill(targetStamp.begin(), targetStamp.end(), 0);
+        targetEpoch = 1;
+    }
+    unsigned count = 0;
+    for (int id : targets) {
+        int index = map.indexOf(id);
+        if (index != -1 && targetStamp[index] != targetEpoch) {
+            targetStamp[index] = targetEpoch;
+            count++;
+        }
+    }
+    return count;
+}
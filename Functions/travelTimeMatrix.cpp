@@ -0,0 +1,157 @@
+/**
+ * @file travelTimeMatrix.cpp
+ * @brief Implements the travel time matrices, with one search per source or with the bucket-based many-to-many method.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include "../include/TravelTimeMatrix.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/WorkStealingScheduler.h"
+
+namespace {
+
+/**
+ * @brief Distance from the vertex of a bucket to one target column.
+ */
+struct BucketEntry {
+    unsigned column;
+    double dist;
+};
+
+/**
+ * @brief Runs task(workspace, i) for every i in [0, count) on a work-stealing pool.
+ *
+ * The first worker runs on the calling thread with the given workspace; the others create their own on first use.
+ */
+void runOnWorkers(const LoadedMap& map, SearchWorkspace& ws, size_t count, unsigned threads,
+                  const std::function<void(SearchWorkspace&, size_t)>& task) {
+    WorkStealingScheduler scheduler(static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, count))));
+    std::vector<std::unique_ptr<SearchWorkspace>> workspaces(scheduler.getNumWorkers());
+    scheduler.run(count, [&](unsigned worker, size_t i) {
+        if (worker > 0 && !workspaces[worker]) workspaces[worker].reset(new SearchWorkspace(map));
+        task(worker == 0 ? ws : *workspaces[worker], i);
+    });
+}
+
+/**
+ * @brief Fills each row with one Dijkstra search from its source, stopped once every target is settled.
+ */
+void dijkstraMatrix(const LoadedMap& map, SearchWorkspace& ws, TravelTimeMatrix& matrix, const std::vector<int>& sourceIndex,
+                    const std::vector<int>& targetIndex, bool driving, unsigned threads) {
+    static const std::unordered_set<int> noIgnore;
+    size_t columns = matrix.targets.size();
+    runOnWorkers(map, ws, matrix.sources.size(), threads, [&](SearchWorkspace& workspace, size_t row) {
+        if (sourceIndex[row] == -1) return;
+        workspace.reset();
+        dijkstraToTargets(map, workspace, workspace.forward, matrix.sources[row], matrix.targets, driving, false, noIgnore);
+        for (size_t column = 0; column < columns; column++) {
+            if (targetIndex[column] != -1) matrix.times[row * columns + column] = workspace.forward.getDist(targetIndex[column]);
+        }
+    });
+}
+
+/**
+ * @brief Fills the matrix with the bucket-based many-to-many method on a contraction hierarchy.
+ *
+ * The backward upward search of each target leaves (column, distance) entries in the buckets of the vertices
+ * it reaches. The forward upward search of each source then scans the buckets of the vertices it reaches:
+ * the shortest path meets its target's search space at its highest vertex, so the smallest sum over the
+ * bucket entries is the travel time. Both kinds of searches are spread over the worker pool; the buckets are
+ * stored contiguously, grouped by vertex, so a source only reads the entries of the vertices it reaches.
+ */
+void bucketMatrix(const LoadedMap& map, SearchWorkspace& ws, TravelTimeMatrix& matrix, const ContractionHierarchy& ch,
+                  const std::vector<int>& sourceIndex, const std::vector<int>& targetIndex, unsigned threads) {
+    size_t columns = matrix.targets.size();
+    unsigned n = map.csr.getNumVertex();
+
+    std::vector<std::vector<std::pair<unsigned, double>>> spaces(columns);
+    runOnWorkers(map, ws, columns, threads, [&](SearchWorkspace& workspace, size_t column) {
+        if (targetIndex[column] == -1) return;
+        ch.upwardSearch(workspace.backward, targetIndex[column], false);
+        for (int v : workspace.backward.getTouched()) spaces[column].emplace_back(v, workspace.backward.getDist(v));
+    });
+
+    std::vector<unsigned> offsets(n + 1, 0);
+    for (const auto& space : spaces) {
+        for (const auto& entry : space) offsets[entry.first + 1]++;
+    }
+    for (unsigned v = 0; v < n; v++) offsets[v + 1] += offsets[v];
+    std::vector<BucketEntry> buckets(offsets[n]);
+    std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+    for (size_t column = 0; column < columns; column++) {
+        for (const auto& entry : spaces[column]) buckets[next[entry.first]++] = BucketEntry{static_cast<unsigned>(column), entry.second};
+        std::vector<std::pair<unsigned, double>>().swap(spaces[column]);
+    }
+
+    runOnWorkers(map, ws, matrix.sources.size(), threads, [&](SearchWorkspace& workspace, size_t row) {
+        if (sourceIndex[row] == -1) return;
+        ch.upwardSearch(workspace.forward, sourceIndex[row], true);
+        double* times = matrix.times.data() + row * columns;
+        for (int v : workspace.forward.getTouched()) {
+            double dv = workspace.forward.getDist(v);
+            for (unsigned i = offsets[v]; i < offsets[v + 1]; i++) {
+                times[buckets[i].column] = std::min(times[buckets[i].column], dv + buckets[i].dist);
+            }
+        }
+    });
+}
+
+} // namespace
+
+/**
+ * @brief Computes the shortest travel times from every source to every target.
+ *
+ * Resolves the location IDs once, then fills the matrix with the selected method.
+ */
+TravelTimeMatrix computeTravelTimeMatrix(const LoadedMap& map, SearchWorkspace& ws, const std::vector<int>& sources,
+                                         const std::vector<int>& targets, bool driving, MatrixMethod method, unsigned threads) {
+    TravelTimeMatrix matrix;
+    matrix.sources = sources;
+    matrix.targets = targets;
+    matrix.times.assign(sources.size() * targets.size(), INF);
+
+    std::vector<int> sourceIndex, targetIndex;
+    for (int id : sources) sourceIndex.push_back(map.indexOf(id));
+    for (int id : targets) targetIndex.push_back(map.indexOf(id));
+
+    bool buckets = method == MatrixMethod::Buckets ||
+                   (method == MatrixMethod::Auto && matrix.times.size() >= MATRIX_BUCKET_MIN_CELLS);
+    if (buckets) bucketMatrix(map, ws, matrix, map.contractionHierarchy(driving), sourceIndex, targetIndex, threads);
+    else dijkstraMatrix(map, ws, matrix, sourceIndex, targetIndex, driving, threads);
+    return matrix;
+}
+
+/**
+ * @brief Writes a travel time matrix: the sources, the targets and one line of times per source.
+ *
+ * @param matrix Matrix to write.
+ * @param out Output stream.
+ */
+void outputTravelTimeMatrix(const TravelTimeMatrix& matrix, std::ostream& out) {
+    const char* separator = "";
+    out << "Sources:";
+    for (int id : matrix.sources) {
+        out << separator << id;
+        separator = ",";
+    }
+    separator = "";
+    out << "\nTargets:";
+    for (int id : matrix.targets) {
+        out << separator << id;
+        separator = ",";
+    }
+    out << "\nTimeMatrix:\n";
+    for (size_t row = 0; row < matrix.sources.size(); row++) {
+        for (size_t column = 0; column < matrix.targets.size(); column++) {
+            if (column > 0) out << ",";
+            double time = matrix.at(row, column);
+            if (time == INF) out << "none";
+            else out << time;
+        }
+        out << "\n";
+    }
+}
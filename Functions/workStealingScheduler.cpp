@@ -0,0 +1,124 @@
+/**
+ * @file workStealingScheduler.cpp
+ * @brief Implementation of the work-stealing scheduler used by batch mode.
+ */
+
+#include <thread>
+#include "../include/WorkStealingScheduler.h"
+
+WorkStealingScheduler::WorkStealingScheduler(unsigned workers) {
+    if (workers == 0) workers = 1;
+    for (unsigned w = 0; w < workers; w++) deques.push_back(std::unique_ptr<Deque>(new Deque()));
+    for (unsigned w = 1; w < workers; w++) pool.emplace_back([this, w]() { serve(w); });
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+    {
+        std::lock_guard<std::mutex> guard(runLock);
+        stopping = true;
+    }
+    started.notify_all();
+    for (std::thread& t : pool) t.join();
+}
+
+std::size_t WorkStealingScheduler::getSteals() const {
+    std::size_t steals = 0;
+    for (const auto& deque : deques) steals += deque->steals;
+    return steals;
+}
+
+void WorkStealingScheduler::run(std::size_t count, const std::function<void(unsigned, std::size_t)>& task) {
+    unsigned workers = getNumWorkers();
+    for (unsigned w = 0; w < workers; w++) {
+        Deque& deque = *deques[w];
+        deque.begin = count * w / workers;
+        deque.end = count * (w + 1) / workers;
+        deque.steals = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(runLock);
+        current = &task;
+        busy = workers - 1;
+        runs++;
+    }
+    started.notify_all();
+    work(0, task);
+
+    std::unique_lock<std::mutex> guard(runLock);
+    finished.wait(guard, [this]() { return busy == 0; });
+    current = nullptr;
+}
+
+/**
+ * @brief Loop of a worker thread: waits for each run, takes part in it, and reports when it is done.
+ *
+ * run() only returns once every worker thread has finished, so a thread cannot miss a run.
+ */
+void WorkStealingScheduler::serve(unsigned worker) {
+    std::size_t served = 0;
+    while (true) {
+        const std::function<void(unsigned, std::size_t)>* task;
+        {
+            std::unique_lock<std::mutex> guard(runLock);
+            started.wait(guard, [this, served]() { return stopping || runs != served; });
+            if (stopping) return;
+            served = runs;
+            task = current;
+        }
+        work(worker, *task);
+        std::lock_guard<std::mutex> guard(runLock);
+        if (--busy == 0) finished.notify_one();
+    }
+}
+
+/**
+ * @brief Runs the tasks of one worker: its own first, then stolen ones, until no worker has any left.
+ *
+ * Tasks are never added during a run, so once a sweep over every other worker finds nothing to steal,
+ * the remaining tasks are already owned by workers that will run them.
+ */
+void WorkStealingScheduler::work(unsigned worker, const std::function<void(unsigned, std::size_t)>& task) {
+    Deque& own = *deques[worker];
+    std::size_t taskIndex;
+    do {
+        while (popFront(own, taskIndex)) task(worker, taskIndex);
+    } while (steal(worker));
+}
+
+bool WorkStealingScheduler::popFront(Deque& deque, std::size_t& taskIndex) {
+    std::lock_guard<std::mutex> guard(deque.lock);
+    if (deque.begin == deque.end) return false;
+    taskIndex = deque.begin++;
+    return true;
+}
+
+/**
+ * @brief Moves the back half of another worker's range into the thief's empty range.
+ *
+ * Victims are tried in turn, starting with the next worker, so thieves spread over different victims.
+ *
+ * @return Whether any task was stolen.
+ */
+bool WorkStealingScheduler::steal(unsigned thief) {
+    unsigned workers = getNumWorkers();
+    for (unsigned i = 1; i < workers; i++) {
+        Deque& victim = *deques[(thief + i) % workers];
+        std::size_t begin, end;
+        {
+            std::lock_guard<std::mutex> guard(victim.lock);
+            std::size_t left = victim.end - victim.begin;
+            if (left == 0) continue;
+            end = victim.end;
+            begin = end - (left + 1) / 2;
+            victim.end = begin;
+        }
+        Deque& own = *deques[thief];
+        std::lock_guard<std::mutex> guard(own.lock);
+        own.begin = begin;
+        own.end = end;
+        own.steals++;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,57 @@
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+/**
+ * @file BenchmarkUtils.h
+ * @brief Synthetic road grids and timing helpers shared by the benchmarks.
+ */
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "../include/CreatingMap.h"
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Milliseconds elapsed since a time point.
+ */
+inline double since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * @brief Builds a road grid of locations with random driving times in [1, 10] and a few closed roads.
+ *
+ * Locations fill rows of side locations in order, each linked to the next one in its row and to the one below.
+ * The same side and seed always give the same grid, so runs of a benchmark stay comparable.
+ *
+ * @param map LoadedMap to fill; its CSR snapshot and indices are built.
+ * @param side Number of locations per row, and per column unless count is given.
+ * @param seed Seed of the random driving and walking times.
+ * @param count Number of locations; side * side if negative.
+ */
+inline void buildGrid(LoadedMap& map, int side, unsigned seed, int count = -1) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> time(1, 10);
+    std::uniform_int_distribution<int> closed(0, 49);
+    if (count < 0) count = side * side;
+
+    std::vector<Location> locations;
+    for (int i = 0; i < count; i++) {
+        locations.emplace_back("GRID" + std::to_string(i + 1), i + 1, "G" + std::to_string(i + 1), 0);
+        map.graph.addVertex(locations.back());
+    }
+    for (int i = 0; i < count; i++) {
+        double walk = 5 * time(rng);
+        if (i % side + 1 < side && i + 1 < count)
+            map.graph.addBidirectionalEdge(locations[i], locations[i + 1], closed(rng) ? time(rng) : INF, walk);
+        if (i + side < count)
+            map.graph.addBidirectionalEdge(locations[i], locations[i + side], closed(rng) ? time(rng) : INF, walk);
+    }
+    map.csr.build(map.graph);
+    indexLocations(map);
+}
+
+#endif // BENCHMARK_UTILS_H
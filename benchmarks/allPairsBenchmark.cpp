@@ -0,0 +1,110 @@
+/**
+ * @file allPairsBenchmark.cpp
+ * @brief Times building, saving and mapping the all-pairs table on the bundled map, and compares table lookups with Dijkstra.
+ *
+ * Builds the table on one thread and on one thread per core, writes it to a temporary file and maps it back,
+ * then answers the same random fastest-route queries, for both metrics, with dijkstraToTarget and with
+ * tableSearch. Checks that the paths are identical; exits with a non-zero status on a mismatch. Also checks
+ * that a synthetic map above ALL_PAIRS_MAX_VERTICES is refused.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "../include/AllPairsTable.h"
+#include "../include/CreatingMap.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+#define QUERIES 2000
+
+/**
+ * @brief Reads the path left in the forward tree, as getBestPath would, without banning its edges.
+ */
+static std::vector<unsigned> treePath(const LoadedMap& map, const SearchWorkspace& ws, unsigned t) {
+    std::vector<unsigned> edges;
+    for (unsigned e; (e = ws.forward.getPath(t)) != NO_EDGE; t = map.csr.getSource(e)) edges.push_back(e);
+    return edges;
+}
+
+int main() {
+    LoadedMap map;
+    createMap(map);
+    SearchWorkspace ws(map);
+    unsigned n = map.csr.getNumVertex();
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    const std::unordered_set<int> noIgnore;
+    long mismatches = 0;
+
+    std::cout << "Bundled data (" << n << " locations)\n";
+    for (unsigned t : std::vector<unsigned>{1, threads}) {
+        auto start = Clock::now();
+        map.allPairs.build(map, ws, t);
+        std::cout << "  Built on " << t << (t == 1 ? " thread" : " threads") << " in " << since(start) << " ms\n";
+        if (t == threads) break;
+    }
+
+    std::string path = "allPairsBenchmark.bin";
+    auto start = Clock::now();
+    map.allPairs.save(path, map.csr);
+    std::cout << "  Saved in " << since(start) << " ms\n";
+    start = Clock::now();
+    bool loaded = map.allPairs.load(path, map.csr);
+    std::cout << "  Mapped in " << since(start) << " ms\n";
+    if (!loaded) {
+        std::cout << "  Could not map the table\n";
+        return 1;
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, n - 1);
+    std::vector<std::pair<int, int>> queries;
+    for (int i = 0; i < QUERIES; i++) queries.emplace_back(map.idOf(pick(rng)), map.idOf(pick(rng)));
+
+    for (bool driving : {true, false}) {
+        std::vector<std::vector<unsigned>> expected;
+        start = Clock::now();
+        for (const auto& q : queries) {
+            ws.reset();
+            dijkstraToTarget(map, ws, ws.forward, q.first, q.second, driving, noIgnore);
+            expected.push_back(treePath(map, ws, map.indexOf(q.second)));
+        }
+        double dijkstraUs = since(start) * 1000 / QUERIES;
+
+        start = Clock::now();
+        for (size_t i = 0; i < queries.size(); i++) {
+            ws.reset();
+            tableSearch(map, ws, queries[i].first, queries[i].second, driving, noIgnore);
+            mismatches += treePath(map, ws, map.indexOf(queries[i].second)) != expected[i];
+        }
+        double tableUs = since(start) * 1000 / QUERIES;
+        std::cout << "  " << (driving ? "Driving" : "Walking") << ": Dijkstra " << dijkstraUs << " us/query, table "
+                  << tableUs << " us/query\n";
+    }
+    std::remove(path.c_str());
+    std::cout << "  Mismatched paths: " << mismatches << "\n";
+
+    LoadedMap large;
+    std::vector<Location> locations;
+    for (int i = 0; i <= ALL_PAIRS_MAX_VERTICES; i++) {
+        locations.emplace_back("SYN" + std::to_string(i + 1), i + 1, "S" + std::to_string(i + 1), 0);
+        large.graph.addVertex(locations.back());
+        if (i > 0) large.graph.addBidirectionalEdge(locations[i - 1], locations[i], 1, 5);
+    }
+    large.csr.build(large.graph);
+    indexLocations(large);
+    SearchWorkspace largeWs(large);
+    bool refused = !large.allPairs.build(large, largeWs, threads) && large.allPairs.empty();
+    std::cout << "Synthetic path (" << large.csr.getNumVertex() << " locations): "
+              << (refused ? "refused, as expected" : "built, but should have been refused") << "\n";
+
+    return mismatches == 0 && refused ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file allocationBenchmark.cpp
+ * @brief Counts heap allocations made while routing, to check that the hot loop never allocates.
+ *
+ * Replaces the global operator new with a counting version, warms up a search workspace and then
+ * runs Dijkstra from many origins (driving and walking). Also sweeps the Graph iteration API
+ * (getVertexSet, getAdj, getIncoming). Exits with a non-zero status if any allocation is observed.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <unordered_set>
+#include "../include/CreatingMap.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+static unsigned long long allocations = 0;
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+int main() {
+    LoadedMap map;
+    createMapFromCsv(map);  // the Graph API is checked below, so the graph must be built
+    SearchWorkspace ws(map);
+    const CsrGraph<Location>& csr = map.csr;
+    const std::unordered_set<int> noIgnore;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, csr.getNumVertex() - 1);
+    const int queries = 1000;
+    std::vector<int> origins;
+    for (int i = 0; i < queries; i++) origins.push_back(map.idOf(pick(rng)));
+
+    // Warm-up: lets the queue and the touched list reach their final capacity
+    for (int origin : origins) {
+        dijkstra(map, ws, ws.forward, origin, true, false, noIgnore);
+        dijkstra(map, ws, ws.forward, origin, false, false, noIgnore);
+    }
+
+    unsigned long long scanned = 0;
+    unsigned long long routingAllocations = 0;
+    auto start = Clock::now();
+    for (int origin : origins) {
+        for (bool driving : {true, false}) {
+            unsigned long long before = allocations;
+            dijkstra(map, ws, ws.forward, origin, driving, false, noIgnore);
+            routingAllocations += allocations - before;
+            for (int v : ws.forward.getTouched()) scanned += csr.edges(v).size();
+        }
+    }
+    double ms = since(start);
+
+    unsigned long long before = allocations;
+    unsigned long long graphEdges = 0;
+    for (const Vertex<Location>* v : map.graph.getVertexSet()) {
+        for (const Edge<Location>* e : v->getAdj()) graphEdges += e->getDriving() != INF;
+        graphEdges += v->getIncoming().size();
+    }
+    unsigned long long iterationAllocations = allocations - before;
+
+    std::cout << "Searches:                 " << 2 * queries << "\n";
+    std::cout << "Edges scanned:            " << scanned << "\n";
+    std::cout << "Time per search:          " << ms / (2 * queries) << " ms\n";
+    std::cout << "Allocations (routing):    " << routingAllocations << "\n";
+    std::cout << "Allocations per edge:     " << (scanned ? double(routingAllocations) / scanned : 0.0) << "\n";
+    std::cout << "Edges visited (Graph API): " << graphEdges << "\n";
+    std::cout << "Allocations (Graph API):  " << iterationAllocations << "\n";
+
+    return routingAllocations == 0 && iterationAllocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file alternativeBenchmark.cpp
+ * @brief Compares the plateau-based alternative routes with the previous node-disjoint alternatives.
+ *
+ * On the bundled map and on a synthetic grid, answers the same random queries with the walking metric that
+ * planFastestRoute searches with:
+ * - the previous method: dijkstraToTarget for the fastest route, then dijkstraToTarget again avoiding its
+ *   intermediate locations and its edges;
+ * - findAlternativeRoute (one forward and one backward search);
+ * - a single bidirectionalDijkstra, for reference.
+ * Reports the time per query, how often an alternative is found and its average stretch and sharing with
+ * the fastest route, and checks that both methods find fastest routes of the same length.
+ * Exits with a non-zero status on a mismatch.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../include/AlternativeRoutes.h"
+#include "../include/CreatingMap.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+/**
+ * @brief Quality of the alternatives found by one method.
+ */
+struct AlternativeStats {
+    int found = 0;
+    double stretch = 0;     // sum of alternative length / fastest length
+    double sharing = 0;     // sum of shared length / fastest length
+    double ms = 0;
+
+    void print(const char* name, int queries) const {
+        std::cout << "  " << name << ": " << ms * 1000 / queries << " us/query, alternative for " << found << "/" << queries;
+        if (found > 0) std::cout << ", stretch " << stretch / found << ", sharing " << sharing / found;
+        std::cout << "\n";
+    }
+};
+
+/**
+ * @brief Length of the part of a route that is also on another route.
+ */
+double sharedLength(const CsrGraph<Location>& csr, const std::vector<unsigned>& route, std::vector<unsigned> other) {
+    std::sort(other.begin(), other.end());
+    double shared = 0;
+    for (unsigned e : route) {
+        if (std::binary_search(other.begin(), other.end(), e)) shared += csr.getWalking(e);
+    }
+    return shared;
+}
+
+/**
+ * @brief Runs every method on random queries of a map.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map.
+ * @param queries Number of random queries.
+ * @return Number of queries whose fastest routes differ in length.
+ */
+long compare(const std::string& name, const LoadedMap& map, int queries) {
+    const CsrGraph<Location>& csr = map.csr;
+    SearchWorkspace ws(map);
+    const std::unordered_set<int> noIgnore;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, csr.getNumVertex() - 1);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < queries; i++) pairs.emplace_back(map.idOf(pick(rng)), map.idOf(pick(rng)));
+
+    std::cout << name << " (" << csr.getNumVertex() << " locations), " << queries << " queries\n";
+    AlternativeStats previous, plateau;
+    std::vector<double> fastest;
+    long mismatches = 0;
+
+    auto start = Clock::now();
+    for (const auto& q : pairs) {
+        ws.reset();
+        dijkstraToTarget(map, ws, ws.forward, q.first, q.second, false, noIgnore);
+        unsigned t = map.indexOf(q.second);
+        double d = ws.forward.getDist(t);
+        fastest.push_back(d);
+        if (d == INF || d == 0) continue;
+
+        std::vector<unsigned> best;
+        std::unordered_set<int> avoid;
+        for (unsigned v = t, e; (e = ws.forward.getPath(v)) != NO_EDGE; v = csr.getSource(e)) {
+            best.push_back(e);
+            ws.banEdge(e);
+            if (csr.getSource(e) != static_cast<unsigned>(map.indexOf(q.first))) avoid.insert(map.idOf(csr.getSource(e)));
+        }
+        dijkstraToTarget(map, ws, ws.forward, q.first, q.second, false, avoid);
+        double alt = ws.forward.getDist(t);
+        if (alt == INF) continue;
+        std::vector<unsigned> route;
+        for (unsigned v = t, e; (e = ws.forward.getPath(v)) != NO_EDGE; v = csr.getSource(e)) route.push_back(e);
+        previous.found++;
+        previous.stretch += alt / d;
+        previous.sharing += sharedLength(csr, route, best) / d;
+    }
+    previous.ms = since(start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < pairs.size(); i++) {
+        AlternativeRoute routes = findAlternativeRoute(map, ws, pairs[i].first, pairs[i].second, false);
+        double d = 0;
+        for (unsigned e : routes.shortest) d += csr.getWalking(e);
+        if (!routes.found) d = INF;
+        mismatches += d != fastest[i];
+        if (!routes.foundAlternative) continue;
+        plateau.found++;
+        plateau.stretch += routes.alternativeDist / d;
+        plateau.sharing += routes.sharing / d;
+    }
+    plateau.ms = since(start);
+
+    start = Clock::now();
+    for (const auto& q : pairs) {
+        ws.reset();
+        bidirectionalDijkstra(map, ws, q.first, q.second, false, noIgnore);
+    }
+    double bidirectionalMs = since(start);
+
+    previous.print("Two Dijkstra searches, node-disjoint", queries);
+    plateau.print("Forward and backward trees, plateaus", queries);
+    std::cout << "  One bidirectional search: " << bidirectionalMs * 1000 / queries << " us/query\n";
+    std::cout << "  Mismatched fastest routes: " << mismatches << "\n";
+    return mismatches;
+}
+
+int main() {
+    long mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map, 2000);
+    }
+    {
+        LoadedMap map;
+        buildGrid(map, 200, 7);
+        mismatches += compare("Synthetic grid", map, 200);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file cchBenchmark.cpp
+ * @brief Measures restricted queries on the customizable contraction hierarchy against Dijkstra.
+ *
+ * For each map, times the metric-independent preprocessing and the customization of one metric, then runs
+ * random queries that each avoid a few random locations and road segments (like AvoidNodes/AvoidSegments
+ * in batch input) with dijkstraToTarget and with customizableSearch. Checks that every distance agrees and
+ * exits with a non-zero status on a mismatch.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/CustomizableHierarchy.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+/**
+ * @brief Builds the customizable hierarchy of a map and times restricted queries against Dijkstra.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map.
+ * @param queries Number of random queries.
+ * @return Number of queries whose distances differ.
+ */
+int compare(const std::string& name, LoadedMap& map, int queries) {
+    SearchWorkspace ws(map);
+    const CsrGraph<Location>& csr = map.csr;
+
+    auto start = Clock::now();
+    map.customizable.build(csr);
+    double buildMs = since(start);
+    start = Clock::now();
+    map.customizable.customize(csr, false);
+    double customizeMs = since(start);
+    map.customizable.customize(csr, true);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pickVertex(0, csr.getNumVertex() - 1);
+    std::uniform_int_distribution<unsigned> pickEdge(0, csr.getNumEdges() - 1);
+
+    int mismatches = 0;
+    double dijkstraMs = 0, cchMs = 0;
+    for (int q = 0; q < queries; q++) {
+        int s = map.idOf(pickVertex(rng)), t = map.idOf(pickVertex(rng));
+        std::unordered_set<int> avoidNodes;
+        for (int i = 0; i < 5; i++) avoidNodes.insert(map.idOf(pickVertex(rng)));
+        avoidNodes.erase(s);
+        avoidNodes.erase(t);
+        std::vector<unsigned> avoidSegments;
+        for (int i = 0; i < 5; i++) avoidSegments.push_back(pickEdge(rng));
+
+        ws.reset();
+        for (unsigned e : avoidSegments) ws.banEdge(e);
+        start = Clock::now();
+        dijkstraToTarget(map, ws, ws.forward, s, t, false, avoidNodes);
+        dijkstraMs += since(start);
+        double expected = ws.forward.getDist(map.indexOf(t));
+
+        start = Clock::now();
+        customizableSearch(map, ws, s, t, false, avoidNodes);
+        cchMs += since(start);
+        mismatches += ws.forward.getDist(map.indexOf(t)) != expected;
+    }
+
+    std::cout << name << " (" << csr.getNumVertex() << " locations, " << csr.getNumEdges() << " edges)\n";
+    std::cout << "  Metric-independent preprocessing: " << buildMs << " ms, " << map.customizable.getNumArcs() << " arcs\n";
+    std::cout << "  Customization (one metric):       " << customizeMs << " ms\n";
+    std::cout << "  Restricted dijkstraToTarget:      " << dijkstraMs * 1000 / queries << " us/query\n";
+    std::cout << "  Restricted CCH query:             " << cchMs * 1000 / queries << " us/query\n";
+    std::cout << "  Mismatched distances:             " << mismatches << "\n";
+    return mismatches;
+}
+
+int main() {
+    int mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map, 1000);
+    }
+    {
+        LoadedMap map;
+        buildGrid(map, 100, 7);
+        mismatches += compare("Synthetic grid", map, 200);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
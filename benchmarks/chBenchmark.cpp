@@ -0,0 +1,92 @@
+/**
+ * @file chBenchmark.cpp
+ * @brief Compares contraction hierarchy queries with Dijkstra on the bundled map and on a synthetic grid.
+ *
+ * For each map, builds the hierarchy of the driving metric and runs the same random queries with the full
+ * dijkstra, with dijkstraToTarget and with the hierarchy. Reports the preprocessing time, the number of
+ * shortcuts and the average latency of each method, and checks that every distance agrees.
+ * Exits with a non-zero status on a mismatch.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/ContractionHierarchy.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+/**
+ * @brief Builds the driving hierarchy of a map and times it against Dijkstra on random queries.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map.
+ * @param queries Number of random queries.
+ * @return Number of queries whose distances differ.
+ */
+int compare(const std::string& name, LoadedMap& map, int queries) {
+    SearchWorkspace ws(map);
+    const std::unordered_set<int> noIgnore;
+
+    auto start = Clock::now();
+    ContractionHierarchy& ch = map.hierarchy[true];
+    ch.build(map.csr, true);
+    double buildMs = since(start);
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, map.csr.getNumVertex() - 1);
+    std::vector<std::pair<unsigned, unsigned>> pairs;
+    for (int i = 0; i < queries; i++) pairs.push_back({pick(rng), pick(rng)});
+
+    std::vector<double> expected, direct;
+    std::vector<unsigned> edges;
+    double fullMs = 0, targetMs = 0, chMs = 0;
+    for (auto& q : pairs) {
+        int s = map.idOf(q.first), t = map.idOf(q.second);
+        ws.reset();
+
+        start = Clock::now();
+        dijkstra(map, ws, ws.forward, s, true, false, noIgnore);
+        fullMs += since(start);
+        expected.push_back(ws.forward.getDist(q.second));
+
+        start = Clock::now();
+        dijkstraToTarget(map, ws, ws.forward, s, t, true, noIgnore);
+        targetMs += since(start);
+
+        start = Clock::now();
+        direct.push_back(ch.query(ws, q.first, q.second, edges));
+        chMs += since(start);
+    }
+
+    int mismatches = 0;
+    for (int i = 0; i < queries; i++) mismatches += expected[i] != direct[i];
+
+    std::cout << name << " (" << map.csr.getNumVertex() << " locations, " << map.csr.getNumEdges() << " edges)\n";
+    std::cout << "  CH preprocessing:       " << buildMs << " ms, " << ch.getNumShortcuts() << " shortcuts\n";
+    std::cout << "  dijkstra (full):        " << fullMs * 1000 / queries << " us/query\n";
+    std::cout << "  dijkstraToTarget:       " << targetMs * 1000 / queries << " us/query\n";
+    std::cout << "  CH query + unpacking:   " << chMs * 1000 / queries << " us/query\n";
+    std::cout << "  Mismatched distances:   " << mismatches << "\n";
+    return mismatches;
+}
+
+int main() {
+    int mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map, 1000);
+    }
+    {
+        LoadedMap map;
+        buildGrid(map, 200, 7);
+        mismatches += compare("Synthetic grid", map, 200);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file csvBenchmark.cpp
+ * @brief Compares the memory-mapped CSV loader, on one thread and on every core, with the previous stream-based one
+ * on a large synthetic extract.
+ *
+ * Writes a Locations.csv with 1M locations and a Distances.csv with 10M rows (about 10% of them marked `X`,
+ * closed to driving) to a temporary directory. Like the bundled data, the rows of each source location are
+ * listed together. Then it loads them into a Graph three times. The first load uses the old ifstream + getline +
+ * istringstream + stoi/stod parsing, kept here as the reference. The other two use readLocations/readDistances,
+ * parsing Distances.csv on one thread and then on one thread per core. Each load runs in its own process, so none
+ * inherits the heap left behind by another.
+ * Reports the time of each phase and checks that every row became a pair of edges.
+ *
+ * Usage: csvBenchmark [rows] (default 10000000). The temporary files are removed at the end.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include "../include/CreatingMap.h"
+
+#define INF std::numeric_limits<double>::max()
+
+typedef std::unordered_map<std::string, Vertex<Location>*> CodeMap;
+
+/**
+ * @brief Writes the synthetic Locations.csv and Distances.csv files.
+ *
+ * Each location in turn gets an equal share of the rows, towards the next location and then random ones.
+ *
+ * @param dir Directory receiving the files.
+ * @param locations Number of locations.
+ * @param rows Number of distance rows.
+ */
+void writeFiles(const std::filesystem::path& dir, int locations, long rows) {
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> pick(1, locations);
+    std::uniform_int_distribution<int> time(1, 20);
+    std::uniform_int_distribution<int> closed(0, 9);
+
+    std::FILE* file = std::fopen((dir / "Locations.csv").string().c_str(), "w");
+    std::fputs("Location,Id,Code,Parking\n", file);
+    for (int i = 1; i <= locations; i++) std::fprintf(file, "STREET %d,%d,C%d,%d\n", i, i, i, i % 3 == 0);
+    std::fclose(file);
+
+    file = std::fopen((dir / "Distances.csv").string().c_str(), "w");
+    std::fputs("Location1,Location2,Driving,Walking\n", file);
+    for (long r = 0; r < rows; r++) {
+        int from = static_cast<int>(r * locations / rows) + 1;
+        int to = r * locations % rows < locations ? from % locations + 1 : pick(rng);
+        int drive = time(rng);
+        if (closed(rng) == 0) std::fprintf(file, "C%d,C%d,X,%d\n", from, to, 5 * drive);
+        else std::fprintf(file, "C%d,C%d,%d,%d\n", from, to, drive, 5 * drive);
+    }
+    std::fclose(file);
+}
+
+/**
+ * @brief Previous readLocations: one istringstream and several temporary strings per row.
+ */
+void legacyReadLocations(Graph<Location>& map, CodeMap& locations, std::unordered_map<int, Vertex<Location>*>& idmap,
+                         const std::string& path) {
+    std::ifstream LocationsFile(path);
+    std::string line;
+    std::getline(LocationsFile, line);  // Ignore header
+
+    while (std::getline(LocationsFile, line)) {
+        std::istringstream iss(line);
+        std::string name, id, code, parking;
+
+        if (std::getline(iss, name, ',') && std::getline(iss, id, ',') &&
+            std::getline(iss, code, ',') && std::getline(iss, parking, ',')) {
+            Location location{name, std::stoi(id), code, std::stoi(parking)};
+            map.addVertex(location);
+            locations[code] = map.findVertex(location);
+            idmap[std::stoi(id)] = map.findVertex(location);
+        }
+    }
+}
+
+/**
+ * @brief Previous readDistances: one istringstream, four strings and two hashed vertex lookups per row.
+ */
+void legacyReadDistances(Graph<Location>& map, CodeMap& locations, const std::string& path) {
+    std::ifstream DistancesFile(path);
+    std::string line;
+    std::getline(DistancesFile, line);  // Ignore header
+
+    while (std::getline(DistancesFile, line)) {
+        std::istringstream iss(line);
+        std::string source, destination, driving, walking;
+
+        if (std::getline(iss, source, ',') && std::getline(iss, destination, ',') &&
+            std::getline(iss, driving, ',') && std::getline(iss, walking, ',')) {
+
+            double driveTime = (driving == "X") ? INF : std::stod(driving);
+            double walkTime = std::stod(walking);
+
+            Vertex<Location>* src = locations[source];
+            Vertex<Location>* dest = locations[destination];
+
+            if (src && dest) {
+                map.addBidirectionalEdge(src->getInfo(), dest->getInfo(), driveTime, walkTime);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Counts the directed edges of a graph.
+ */
+size_t countEdges(const Graph<Location>& graph) {
+    size_t edges = 0;
+    for (const Vertex<Location>* v : graph.getVertexSet()) edges += v->getAdj().size();
+    return edges;
+}
+
+/**
+ * @brief Loads the files with one loader and prints the time of each phase.
+ *
+ * @param name Label printed with the results.
+ * @param legacy Whether to use the previous stream-based loader.
+ * @param threads Number of threads parsing Distances.csv with readDistances, 0 for one per core.
+ * @param dir Directory holding the files.
+ * @return Number of directed edges loaded.
+ */
+size_t load(const std::string& name, bool legacy, unsigned threads, const std::filesystem::path& dir) {
+    typedef std::chrono::steady_clock Clock;
+    Graph<Location> graph;
+    CodeMap locations;
+    std::unordered_map<int, Vertex<Location>*> idmap;
+
+    auto start = Clock::now();
+    if (legacy) legacyReadLocations(graph, locations, idmap, (dir / "Locations.csv").string());
+    else readLocations(graph, locations, idmap, (dir / "Locations.csv").string());
+    auto middle = Clock::now();
+    if (legacy) legacyReadDistances(graph, locations, (dir / "Distances.csv").string());
+    else readDistances(graph, locations, (dir / "Distances.csv").string(), threads);
+    auto end = Clock::now();
+
+    size_t edges = countEdges(graph);
+    std::cout << name << ":\n"
+              << "  Locations: " << std::chrono::duration<double>(middle - start).count() << " s\n"
+              << "  Distances: " << std::chrono::duration<double>(end - middle).count() << " s ("
+              << edges << " directed edges)" << std::endl;
+    return edges;
+}
+
+int main(int argc, char* argv[]) {
+    // Child process: csvBenchmark --load legacy|single|parallel <dir> <rows>
+    if (argc == 5 && std::string(argv[1]) == "--load") {
+        std::string loader = argv[2];
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        size_t edges = loader == "legacy" ? load("Stream-based loader (previous)", true, 0, argv[3])
+                     : loader == "single" ? load("Memory-mapped loader, 1 thread", false, 1, argv[3])
+                     : load("Memory-mapped loader, " + std::to_string(cores) + (cores == 1 ? " thread" : " threads"), false, cores, argv[3]);
+        return edges == 2 * std::stoul(argv[4]) ? 0 : 1;
+    }
+
+    long rows = argc > 1 ? std::stol(argv[1]) : 10000000;
+    int locations = static_cast<int>(std::max(1L, rows / 10));
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "mygps_csv_benchmark";
+    std::filesystem::create_directories(dir);
+
+    auto start = std::chrono::steady_clock::now();
+    writeFiles(dir, locations, rows);
+    std::cout << "Wrote " << locations << " locations and " << rows << " distance rows ("
+              << std::filesystem::file_size(dir / "Distances.csv") / (1 << 20) << " MiB) in "
+              << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+
+    int failures = 0;
+    for (const char* loader : {"legacy", "single", "parallel"}) {
+        std::string command = "\"" + std::string(argv[0]) + "\" --load " + loader + " \"" + dir.string() + "\" " + std::to_string(rows);
+        if (std::system(command.c_str()) != 0) {
+            std::cout << "  Not every row was loaded as a pair of edges\n";
+            failures++;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+    return failures == 0 ? 0 : 1;
+}
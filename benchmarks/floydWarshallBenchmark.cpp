@@ -0,0 +1,96 @@
+/**
+ * @file floydWarshallBenchmark.cpp
+ * @brief Compares the blocked Floyd-Warshall algorithm with the textbook triple loop.
+ *
+ * On the driving times of the bundled map and on synthetic road grids (4096 and 8192 locations by default, or
+ * the sizes given as arguments), times floydWarshallReference, the blocked version on one thread and on one
+ * thread per core, and checks that every entry agrees. On the bundled map the distances are also checked against
+ * the all-pairs table built with one Dijkstra search per location. Exits with a non-zero status on a mismatch.
+ *
+ * The textbook loop takes minutes on 8192 locations. Run it from the build directory, like the main program,
+ * so that ../data is found.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/FloydWarshall.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+/**
+ * @brief Counts the entries that differ between two matrices of the same size.
+ */
+long countMismatches(const DistanceMatrix& a, const DistanceMatrix& b) {
+    long mismatches = 0;
+    for (unsigned i = 0; i < a.size(); i++) {
+        for (unsigned j = 0; j < a.size(); j++) mismatches += a.at(i, j) != b.at(i, j);
+    }
+    return mismatches;
+}
+
+/**
+ * @brief Times every version on the driving times of a map.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map.
+ * @return Number of entries that differ from the reference.
+ */
+long compare(const std::string& name, const LoadedMap& map) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned n = map.csr.getNumVertex();
+    std::cout << name << " (" << n << " locations), " << (floydWarshallUsesAvx2() ? "AVX2" : "portable") << " kernel\n";
+
+    DistanceMatrix reference = segmentMatrix(map.csr, true);
+    auto start = Clock::now();
+    floydWarshallReference(reference);
+    std::cout << "  Reference: " << since(start) << " ms\n";
+
+    long mismatches = 0;
+    for (unsigned t : std::vector<unsigned>{1, threads}) {
+        DistanceMatrix blocked = segmentMatrix(map.csr, true);
+        start = Clock::now();
+        floydWarshall(blocked, t);
+        std::cout << "  Blocked on " << t << (t == 1 ? " thread: " : " threads: ") << since(start) << " ms\n";
+        mismatches += countMismatches(reference, blocked);
+        if (t == threads) break;
+    }
+    std::cout << "  Mismatched entries: " << mismatches << "\n";
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++) sizes.push_back(std::atoi(argv[i]));
+    if (sizes.empty()) sizes = {4096, 8192};
+
+    long mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map);
+
+        SearchWorkspace ws(map);
+        DistanceMatrix blocked = segmentMatrix(map.csr, true);
+        floydWarshall(blocked);
+        auto start = Clock::now();
+        map.allPairs.build(map, ws, 1);
+        long dijkstraMismatches = 0;
+        for (unsigned s = 0; s < blocked.size(); s++) {
+            for (unsigned t = 0; t < blocked.size(); t++) dijkstraMismatches += blocked.at(s, t) != map.allPairs.getDist(true, s, t);
+        }
+        std::cout << "  All-pairs table with Dijkstra (both metrics and paths, 1 thread): " << since(start)
+                  << " ms, mismatched entries: " << dijkstraMismatches << "\n";
+        mismatches += dijkstraMismatches;
+    }
+    for (int n : sizes) {
+        LoadedMap map;
+        buildGrid(map, 64, 7, n);
+        mismatches += compare("Synthetic grid", map);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file heapBenchmark.cpp
+ * @brief Compares the priority queues available to Dijkstra (see QueueKind) on maps of increasing size.
+ *
+ * For the bundled map and for synthetic grids of 10k, 250k and 1M locations, runs the same full Dijkstra
+ * searches with every queue kind, including the bucket queue (all weights are integers). Reports the average
+ * time per search and the fastest kind for each size.
+ * Checks that every queue produces the same distances and exits with a non-zero status on a mismatch.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+/**
+ * @brief Times full Dijkstra searches with every queue kind on one map.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map.
+ * @param queries Number of searches per queue kind.
+ * @return Number of searches whose distances differ from the binary queue's.
+ */
+int compare(const std::string& name, const LoadedMap& map, int queries) {
+    const QueueKind kinds[] = {QueueKind::Binary, QueueKind::FourAry, QueueKind::EightAry, QueueKind::Pairing, QueueKind::Bucket};
+    SearchWorkspace ws(map);
+    const std::unordered_set<int> noIgnore;
+    unsigned n = map.csr.getNumVertex();
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, n - 1);
+    std::vector<int> origins;
+    for (int i = 0; i < queries; i++) origins.push_back(map.idOf(pick(rng)));
+
+    std::cout << name << " (" << n << " locations, " << map.csr.getNumEdges() << " edges)\n";
+    for (QueueKind kind : kinds) {
+        ws.setQueueKind(kind);
+        dijkstra(map, ws, ws.forward, origins[0], true, false, noIgnore);   // sizes the queue
+    }
+
+    // Every origin is searched with each kind in turn, so a slow phase of the machine affects them all alike
+    double ms[5] = {0, 0, 0, 0, 0};
+    int mismatches = 0;
+    for (int origin : origins) {
+        double expected = 0;
+        for (int k = 0; k < 5; k++) {
+            ws.setQueueKind(kinds[k]);
+            auto start = Clock::now();
+            dijkstra(map, ws, ws.forward, origin, true, false, noIgnore);
+            ms[k] += since(start);
+
+            double total = 0;
+            for (int v : ws.forward.getTouched()) total += ws.forward.getDist(v);
+            if (k == 0) expected = total;
+            else mismatches += total != expected;
+        }
+    }
+
+    int best = 0;
+    for (int k = 0; k < 5; k++) {
+        if (ms[k] < ms[best]) best = k;
+        std::cout << "  " << queueKindName(kinds[k]) << ":\t" << ms[k] * 1000 / queries << " us/search\n";
+    }
+    std::cout << "  Fastest: " << queueKindName(kinds[best]) << "\n";
+    std::cout << "  Mismatched distances: " << mismatches << "\n";
+    return mismatches;
+}
+
+int main() {
+    int mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map, 1000);
+    }
+    const int sides[] = {100, 500, 1000};
+    const int queries[] = {200, 20, 10};
+    for (int i = 0; i < 3; i++) {
+        LoadedMap map;
+        buildGrid(map, sides[i], 7);
+        detectIntegralWeights(map);
+        mismatches += compare("Synthetic grid " + std::to_string(sides[i]) + "x" + std::to_string(sides[i]), map, queries[i]);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
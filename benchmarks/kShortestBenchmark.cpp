@@ -0,0 +1,150 @@
+/**
+ * @file kShortestBenchmark.cpp
+ * @brief Compares the K shortest routes engine with textbook Yen.
+ *
+ * On the bundled map and on a synthetic grid, answers the same random queries with the walking metric that
+ * planFastestRoute searches with, for K = 10:
+ * - textbook Yen: dijkstraToTarget for the first route, then one dijkstraToTarget per spur vertex of every
+ *   accepted route, with the same bans;
+ * - kShortestPaths (one reverse search, tree paths and guided spur searches, Lawler's rule).
+ * Reports the time per query and the searches and vertices settled, and checks that both find the same number of
+ * routes with the same lengths. Exits with a non-zero status on a mismatch.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/KShortestPaths.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+#define BENCHMARK_K 10
+
+/**
+ * @brief Textbook Yen: one Dijkstra search per spur vertex of every accepted route.
+ *
+ * @param searches Incremented by the number of Dijkstra searches run.
+ * @return The lengths of up to k shortest loopless routes, in increasing order.
+ */
+std::vector<double> plainYen(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, unsigned k, long& searches) {
+    const CsrGraph<Location>& csr = map.csr;
+    unsigned t = map.indexOf(destination);
+    auto pathTo = [&csr, t](const SearchTree& tree) {
+        std::vector<unsigned> edges;
+        for (unsigned v = t, e; (e = tree.getPath(v)) != NO_EDGE; v = csr.getSource(e)) edges.push_back(e);
+        std::reverse(edges.begin(), edges.end());
+        return edges;
+    };
+    auto length = [&csr](const std::vector<unsigned>& edges) {
+        double dist = 0;
+        for (unsigned e : edges) dist += csr.getWalking(e);
+        return dist;
+    };
+
+    std::vector<std::vector<unsigned>> routes;
+    std::vector<double> lengths;
+    ws.reset();
+    dijkstraToTarget(map, ws, ws.forward, origin, destination, false, std::unordered_set<int>());
+    searches++;
+    if (ws.forward.getDist(t) == INF) return lengths;
+    routes.push_back(pathTo(ws.forward));
+    lengths.push_back(length(routes.back()));
+
+    std::map<std::pair<double, std::vector<unsigned>>, bool> candidates;
+    while (routes.size() < k) {
+        std::vector<unsigned> last = routes.back();
+        std::unordered_set<int> root;
+        unsigned spur = map.indexOf(origin);
+        for (unsigned i = 0; i < last.size(); root.insert(map.idOf(spur)), spur = csr.getTarget(last[i++])) {
+            ws.reset();
+            for (const std::vector<unsigned>& route : routes) {
+                if (route.size() > i && std::equal(last.begin(), last.begin() + i, route.begin())) ws.banEdge(route[i]);
+            }
+            dijkstraToTarget(map, ws, ws.forward, map.idOf(spur), destination, false, root);
+            searches++;
+            if (ws.forward.getDist(t) == INF) continue;
+            std::vector<unsigned> edges(last.begin(), last.begin() + i);
+            std::vector<unsigned> spurPath = pathTo(ws.forward);
+            edges.insert(edges.end(), spurPath.begin(), spurPath.end());
+            double dist = length(edges);
+            candidates.emplace(std::make_pair(dist, std::move(edges)), true);
+        }
+        if (candidates.empty()) break;
+        routes.push_back(candidates.begin()->first.second);
+        lengths.push_back(candidates.begin()->first.first);
+        candidates.erase(candidates.begin());
+    }
+    return lengths;
+}
+
+/**
+ * @brief Runs both engines on random queries of a map.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map.
+ * @param queries Number of random queries.
+ * @return Number of queries whose route lengths differ.
+ */
+long compare(const std::string& name, const LoadedMap& map, int queries) {
+    const CsrGraph<Location>& csr = map.csr;
+    SearchWorkspace ws(map);
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, csr.getNumVertex() - 1);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < queries; i++) pairs.emplace_back(map.idOf(pick(rng)), map.idOf(pick(rng)));
+
+    std::cout << name << " (" << csr.getNumVertex() << " locations), " << queries << " queries, K = " << BENCHMARK_K << "\n";
+
+    std::vector<std::vector<double>> expected;
+    long plainSearches = 0;
+    unsigned long long settledBefore = ws.stats.settled;
+    auto start = Clock::now();
+    for (const auto& q : pairs) expected.push_back(plainYen(map, ws, q.first, q.second, BENCHMARK_K, plainSearches));
+    double plainMs = since(start);
+    unsigned long long plainSettled = ws.stats.settled - settledBefore;
+
+    long mismatches = 0, routes = 0;
+    settledBefore = ws.stats.settled;
+    start = Clock::now();
+    for (size_t i = 0; i < pairs.size(); i++) {
+        std::vector<RankedRoute> found = kShortestPaths(map, ws, pairs[i].first, pairs[i].second, BENCHMARK_K, false);
+        routes += found.size();
+        bool same = found.size() == expected[i].size();
+        for (size_t r = 0; same && r < found.size(); r++) {
+            same = std::fabs(found[r].dist - expected[i][r]) <= 1e-9 * std::max(1.0, expected[i][r]);
+        }
+        mismatches += !same;
+    }
+    double fastMs = since(start);
+
+    std::cout << "  Textbook Yen: " << plainMs / queries << " ms/query, " << plainSearches / queries << " Dijkstra searches and "
+              << plainSettled / queries << " vertices settled/query\n";
+    std::cout << "  Guided spur searches: " << fastMs / queries << " ms/query, "
+              << (ws.stats.settled - settledBefore) / queries << " vertices settled/query besides the reverse search\n";
+    std::cout << "  Routes found: " << routes << ", mismatched queries: " << mismatches << "\n";
+    return mismatches;
+}
+
+int main() {
+    long mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map, 500);
+    }
+    {
+        LoadedMap map;
+        buildGrid(map, 100, 7);
+        mismatches += compare("Synthetic grid", map, 50);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
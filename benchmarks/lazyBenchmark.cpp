@@ -0,0 +1,105 @@
+/**
+ * @file lazyBenchmark.cpp
+ * @brief Compares Dijkstra with decrease-key against the lazy-deletion variant on the same queries.
+ *
+ * For the bundled map and for synthetic grids of 10k and 250k locations, runs the same point-to-point
+ * dijkstraToTarget queries (driving and walking) with the binary MutablePriorityQueue, the lazy-deletion
+ * heap and the bucket queue, and reports per query the settled vertices, queue pushes and pops, and the wall time.
+ * Checks that every variant finds the same distances and exits with a non-zero status on a mismatch.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "BenchmarkUtils.h"
+
+/**
+ * @brief Runs the same queries with each variant and prints their work counters and latency.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map.
+ * @param queries Number of random queries per metric.
+ * @return Number of queries whose distances differ from the decrease-key variant's.
+ */
+int compare(const std::string& name, const LoadedMap& map, int queries) {
+    const QueueKind kinds[] = {QueueKind::Binary, QueueKind::Lazy, QueueKind::Bucket};
+    const int numKinds = 3;
+    SearchWorkspace ws(map);
+    const std::unordered_set<int> noIgnore;
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, map.csr.getNumVertex() - 1);
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < queries; i++) pairs.push_back({map.idOf(pick(rng)), map.idOf(pick(rng))});
+
+    std::cout << name << " (" << map.csr.getNumVertex() << " locations, " << map.csr.getNumEdges() << " edges)\n";
+    int mismatches = 0;
+    for (bool driving : {true, false}) {
+        SearchStats stats[numKinds];
+        double ms[numKinds] = {0, 0, 0};
+        for (int k = 0; k < numKinds; k++) {
+            ws.setQueueKind(kinds[k]);
+            dijkstraToTarget(map, ws, ws.forward, pairs[0].first, pairs[0].second, driving, noIgnore);   // warm-up
+        }
+        // Each query runs with every variant in turn, so a slow phase of the machine affects them all alike
+        for (auto& q : pairs) {
+            double expected = 0;
+            for (int k = 0; k < numKinds; k++) {
+                ws.setQueueKind(kinds[k]);
+                ws.stats = SearchStats();
+                auto start = Clock::now();
+                dijkstraToTarget(map, ws, ws.forward, q.first, q.second, driving, noIgnore);
+                ms[k] += since(start);
+
+                SearchStats& s = stats[k];
+                s.settled += ws.stats.settled;
+                s.inserts += ws.stats.inserts;
+                s.decreases += ws.stats.decreases;
+                s.stalePops += ws.stats.stalePops;
+                double dist = ws.forward.getDist(map.indexOf(q.second));
+                if (k == 0) expected = dist;
+                else mismatches += dist != expected;
+            }
+        }
+
+        std::cout << "  " << (driving ? "Driving" : "Walking") << " (per query)\n";
+        std::cout << "    queue     settled     pushes       pops    time (us)\n";
+        for (int k = 0; k < numKinds; k++) {
+            bool lazy = kinds[k] == QueueKind::Lazy;
+            std::cout << "    " << std::left << std::setw(8) << queueKindName(kinds[k]) << std::right << std::fixed
+                      << std::setprecision(1) << std::setw(9) << double(stats[k].settled) / queries
+                      << std::setw(11) << double(stats[k].pushes(lazy)) / queries
+                      << std::setw(11) << double(stats[k].pops()) / queries
+                      << std::setw(13) << ms[k] * 1000 / queries << "\n";
+        }
+        std::cout.unsetf(std::ios::floatfield);
+    }
+    std::cout << "  Mismatched distances: " << mismatches << "\n";
+    return mismatches;
+}
+
+int main() {
+    int mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map, 2000);
+    }
+    const int sides[] = {100, 500};
+    const int queries[] = {300, 30};
+    for (int i = 0; i < 2; i++) {
+        LoadedMap map;
+        buildGrid(map, sides[i], 7);
+        detectIntegralWeights(map);
+        mismatches += compare("Synthetic grid " + std::to_string(sides[i]) + "x" + std::to_string(sides[i]), map, queries[i]);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file loadBenchmark.cpp
+ * @brief Measures how map loading scales with the number of locations.
+ *
+ * Builds synthetic graphs of 1k, 100k and 1M locations through the same Graph calls used by
+ * readLocations/readDistances (addVertex, findVertex, addBidirectionalEdge) and reports the
+ * time per location. With hashed vertex lookup the time per location stays flat.
+ * Also times loading the bundled data (run it from the build directory) from the CSV files and from a
+ * binary map file, and loading each synthetic map back from a map file, checking that the loaded
+ * graph has the same fingerprint as the one written.
+ */
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/Landmarks.h"
+#include "../include/MapFile.h"
+#include "BenchmarkUtils.h"
+
+/**
+ * @brief Loads a synthetic road network with the given number of locations.
+ *
+ * Every location is linked to the next one and to the one sqrt(n) positions ahead,
+ * giving roughly two road segments per location, like Distances.csv.
+ *
+ * @param n Number of locations.
+ * @return Elapsed time in milliseconds.
+ */
+double loadSynthetic(int n) {
+    std::vector<Location> locations;
+    locations.reserve(n);
+    for (int i = 1; i <= n; i++) {
+        locations.emplace_back("LOC" + std::to_string(i), i, "C" + std::to_string(i), i % 3 == 0);
+    }
+
+    int stride = 1;
+    while (stride * stride < n) stride++;
+
+    auto start = Clock::now();
+    {
+        Graph<Location> g;
+        for (const Location& location : locations) {
+            g.addVertex(location);
+            g.findVertex(location);
+        }
+        for (int i = 0; i < n; i++) {
+            if (i + 1 < n)
+                g.addBidirectionalEdge(locations[i], locations[i + 1], 3, 15);
+            if (i + stride < n)
+                g.addBidirectionalEdge(locations[i], locations[i + stride], 5, 25);
+        }
+    }
+    return since(start);
+}
+
+/**
+ * @brief Builds the same synthetic network as loadSynthetic into a LoadedMap, with its snapshot and indices.
+ */
+void buildSynthetic(LoadedMap& map, int n) {
+    std::vector<Location> locations;
+    for (int i = 1; i <= n; i++) {
+        locations.emplace_back("LOC" + std::to_string(i), i, "C" + std::to_string(i), i % 3 == 0);
+        map.graph.addVertex(locations.back());
+    }
+    int stride = 1;
+    while (stride * stride < n) stride++;
+    for (int i = 0; i < n; i++) {
+        if (i + 1 < n)
+            map.graph.addBidirectionalEdge(locations[i], locations[i + 1], 3, 15);
+        if (i + stride < n)
+            map.graph.addBidirectionalEdge(locations[i], locations[i + stride], 5, 25);
+    }
+    map.csr.build(map.graph);
+    indexLocations(map);
+    detectIntegralWeights(map);
+}
+
+/**
+ * @brief Writes a map to a map file and times mapping it back.
+ *
+ * @param built Map to write.
+ * @param path Path of the map file, removed afterwards.
+ * @return Elapsed time of loadMapFile in milliseconds, or -1 if the file could not be written or read back
+ *         or the loaded graph differs.
+ */
+double loadFromMapFile(const LoadedMap& built, const std::string& path) {
+    if (!saveMapFile(built, path, {})) return -1;
+    auto start = Clock::now();
+    LoadedMap map;
+    bool loaded = loadMapFile(map, path, {});
+    double ms = since(start);
+    std::filesystem::remove(path);
+    if (!loaded || graphFingerprint(map.csr) != graphFingerprint(built.csr)) return -1;
+    return ms;
+}
+
+int main() {
+    std::string path = (std::filesystem::temp_directory_path() / "mygps_load_benchmark.bin").string();
+    bool identical = true;
+
+    auto start = Clock::now();
+    {
+        LoadedMap map;
+        createMapFromCsv(map);
+        std::cout << "CSV files (bundled data): " << since(start) << " ms\n";
+        double ms = loadFromMapFile(map, path);
+        identical = identical && ms >= 0;
+        std::cout << "Map file (bundled data):  " << ms << " ms\n";
+    }
+
+    for (int n : {1000, 100000, 1000000}) {
+        double ms = loadSynthetic(n);
+        std::cout << "Synthetic " << n << " locations: " << ms << " ms ("
+                  << ms * 1e6 / n << " ns per location)";
+        LoadedMap map;
+        buildSynthetic(map, n);
+        double mapped = loadFromMapFile(map, path);
+        identical = identical && mapped >= 0;
+        std::cout << ", from a map file: " << mapped << " ms\n";
+    }
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file matrixBenchmark.cpp
+ * @brief Compares the ways of filling a driving time matrix on the bundled map and on a synthetic grid.
+ *
+ * For matrices from one source to 100 targets up to 300 x 300, picked at random, fills the matrix with one
+ * dijkstraToTarget per pair (what calling the route planner per pair amounts to, without the map reload),
+ * with computeTravelTimeMatrix using one search per source and with the bucket-based many-to-many method on
+ * the contraction hierarchy. The last two run on one thread per core. Reports the time of each method and
+ * checks that every entry agrees; exits with a non-zero status on a mismatch.
+ *
+ * Run it from the build directory, like the main program, so that ../data is found.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "../include/CreatingMap.h"
+#include "../include/ContractionHierarchy.h"
+#include "../include/RoutePlanningUtils.h"
+#include "../include/SearchWorkspace.h"
+#include "../include/TravelTimeMatrix.h"
+#include "BenchmarkUtils.h"
+
+// Largest matrix, in cells, also filled pair by pair
+#define MAX_PAIRWISE_CELLS 10000
+
+/**
+ * @brief Times every method on random matrices of a map.
+ *
+ * @param name Label printed with the results.
+ * @param map The loaded map; its driving hierarchy is built here.
+ * @return Number of matrix entries that differ between the methods.
+ */
+long compare(const std::string& name, LoadedMap& map) {
+    SearchWorkspace ws(map);
+    const std::unordered_set<int> noIgnore;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto start = Clock::now();
+    map.hierarchy[true].build(map.csr, true);
+    std::cout << name << " (" << map.csr.getNumVertex() << " locations), CH built in "
+              << since(start) << " ms, "
+              << threads << (threads == 1 ? " thread" : " threads") << "\n";
+
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> pick(0, map.csr.getNumVertex() - 1);
+    long mismatches = 0;
+    for (auto shape : std::vector<std::pair<int, int>>{{1, 100}, {10, 100}, {100, 100}, {300, 300}}) {
+        std::vector<int> sources, targets;
+        for (int i = 0; i < shape.first; i++) sources.push_back(map.idOf(pick(rng)));
+        for (int i = 0; i < shape.second; i++) targets.push_back(map.idOf(pick(rng)));
+
+        start = Clock::now();
+        TravelTimeMatrix perSource = computeTravelTimeMatrix(map, ws, sources, targets, true, MatrixMethod::Dijkstra, threads);
+        double perSourceMs = since(start);
+
+        start = Clock::now();
+        TravelTimeMatrix buckets = computeTravelTimeMatrix(map, ws, sources, targets, true, MatrixMethod::Buckets, threads);
+        double bucketsMs = since(start);
+        for (size_t i = 0; i < buckets.times.size(); i++) mismatches += buckets.times[i] != perSource.times[i];
+
+        std::cout << "  " << shape.first << " x " << shape.second << ":";
+        if (perSource.times.size() <= MAX_PAIRWISE_CELLS) {
+            start = Clock::now();
+            for (size_t r = 0; r < sources.size(); r++) {
+                for (size_t c = 0; c < targets.size(); c++) {
+                    ws.reset();
+                    dijkstraToTarget(map, ws, ws.forward, sources[r], targets[c], true, noIgnore);
+                    mismatches += ws.forward.getDist(map.indexOf(targets[c])) != perSource.at(r, c);
+                }
+            }
+            std::cout << " per pair " << since(start) << " ms,";
+        }
+        std::cout << " per source " << perSourceMs << " ms, buckets " << bucketsMs << " ms\n";
+    }
+    std::cout << "  Mismatched entries: " << mismatches << "\n";
+    return mismatches;
+}
+
+int main() {
+    long mismatches = 0;
+    {
+        LoadedMap map;
+        createMap(map);
+        mismatches += compare("Bundled data", map);
+    }
+    {
+        LoadedMap map;
+        buildGrid(map, 200, 7);
+        mismatches += compare("Synthetic grid", map);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+#ifndef ALL_PAIRS_TABLE_H
+#define ALL_PAIRS_TABLE_H
+
+/**
+ * @file AllPairsTable.h
+ * @brief Precomputed all-pairs shortest travel times and paths, for small maps.
+ */
+
+#include <string>
+#include <vector>
+#include "data_structures/CsrGraph.h"
+#include "data_structures/FrozenArray.h"
+#include "Location.h"
+#include "MappedFile.h"
+
+// Largest map, in locations, for which an all-pairs table is built (about 400 MB for both metrics)
+#define ALL_PAIRS_MAX_VERTICES 4096
+
+struct LoadedMap;
+class SearchWorkspace;
+
+/**
+ * @class AllPairsTable
+ * @brief Shortest travel time and last edge of the shortest path between every pair of locations, per metric.
+ *
+ * Each metric has two contiguous V x V row-major arrays indexed by [source * V + target]: the travel time and
+ * the CSR index of the last edge of the path. Row s is the search tree of a Dijkstra search from s, so the
+ * paths are the ones dijkstraToTarget finds, and a path is unpacked by following the last edges back to s.
+ *
+ * The table is written to a file tagged with the graph fingerprint and is memory-mapped from it afterwards,
+ * so processes on the same machine share it. Like the searches, only edges open to driving are used.
+ */
+class AllPairsTable {
+public:
+    AllPairsTable() = default;
+    AllPairsTable(const AllPairsTable&) = delete;
+    AllPairsTable& operator=(const AllPairsTable&) = delete;
+
+    /**
+     * @brief Computes the table for both metrics with one Dijkstra search per source and metric.
+     *
+     * @param map The loaded map.
+     * @param ws Workspace of the calling thread; the other workers create their own.
+     * @param threads Number of worker threads (at least 1).
+     * @return False, leaving the table empty, if the map has more than ALL_PAIRS_MAX_VERTICES locations.
+     * @note **Time Complexity:** O(V (V + E) log V / T) for T threads; O(V^2) memory.
+     */
+    bool build(const LoadedMap& map, SearchWorkspace& ws, unsigned threads);
+
+    /**
+     * @brief Writes the table to a binary file, tagged with a fingerprint of the graph.
+     *
+     * @param path Path of the file.
+     * @param csr Graph the table was computed for.
+     * @return True if the file was written.
+     */
+    bool save(const std::string& path, const CsrGraph<Location>& csr) const;
+
+    /**
+     * @brief Maps a table written by save().
+     *
+     * @param path Path of the file.
+     * @param csr Graph the table must belong to.
+     * @return True if the file exists and matches the graph.
+     * @note **Time Complexity:** O(V + E) to fingerprint the graph; the table itself is not read until used.
+     */
+    bool load(const std::string& path, const CsrGraph<Location>& csr);
+
+    /**
+     * @brief Checks whether the table was built or loaded.
+     */
+    bool empty() const {
+        return numVertex == 0;
+    }
+
+    /**
+     * @brief Shortest travel time from one vertex to another.
+     *
+     * @param driving True for driving times; false for walking times.
+     * @param s Dense index of the origin.
+     * @param t Dense index of the destination.
+     * @return The travel time, or INF if t cannot be reached.
+     */
+    double getDist(bool driving, unsigned s, unsigned t) const {
+        return dist[driving][static_cast<size_t>(s) * numVertex + t];
+    }
+
+    /**
+     * @brief Last edge of the shortest path from one vertex to another.
+     *
+     * @param driving True for driving times; false for walking times.
+     * @param s Dense index of the origin.
+     * @param t Dense index of the destination.
+     * @return The CSR index of the edge, or NO_EDGE if s == t or t cannot be reached.
+     */
+    unsigned getLastEdge(bool driving, unsigned s, unsigned t) const {
+        return last[driving][static_cast<size_t>(s) * numVertex + t];
+    }
+
+    /**
+     * @brief Appends the CSR edges of the shortest path from one vertex to another, in order.
+     *
+     * @param driving True for driving times; false for walking times.
+     * @param s Dense index of the origin.
+     * @param t Dense index of the destination.
+     * @param csr CSR snapshot of the graph.
+     * @param edges Receives the edges (none if s == t or t cannot be reached).
+     * @note **Time Complexity:** O(P), P = number of edges of the path.
+     */
+    void path(bool driving, unsigned s, unsigned t, const CsrGraph<Location>& csr, std::vector<unsigned>& edges) const;
+
+private:
+    unsigned numVertex = 0;
+    MappedFile file;                    // file the arrays point into, when loaded
+    FrozenArray<double> dist[2];        // dist[m][s * V + t], per metric (index 1 = driving)
+    FrozenArray<unsigned> last[2];      // last[m][s * V + t] = last edge of the path, or NO_EDGE
+};
+
+/**
+ * @brief Maps the all-pairs table of the map, or computes it and stores it for the next run.
+ *
+ * Maps larger than ALL_PAIRS_MAX_VERTICES are refused with a message, and the table stays empty.
+ *
+ * @param map The loaded map; its all-pairs table is filled.
+ * @param ws Workspace used by the calling thread.
+ * @param path Path of the table file, kept next to the data files.
+ * @param threads Number of worker threads, 0 for one per core.
+ * @note **Time Complexity:** O(V + E) when the file is up to date; O(V (V + E) log V / T) otherwise.
+ */
+void prepareAllPairsTable(LoadedMap& map, SearchWorkspace& ws, const std::string& path = "../data/AllPairs.bin",
+                          unsigned threads = 0);
+
+#endif // ALL_PAIRS_TABLE_H
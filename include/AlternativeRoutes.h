@@ -0,0 +1,63 @@
+#ifndef ALTERNATIVE_ROUTES_H
+#define ALTERNATIVE_ROUTES_H
+
+/**
+ * @file AlternativeRoutes.h
+ * @brief Alternative routes chosen among the plateaus of a forward and a backward shortest-path tree.
+ */
+
+#include <vector>
+#include "CreatingMap.h"
+#include "SearchWorkspace.h"
+
+// Admissibility of an alternative route, as fractions of the shortest travel time d:
+// at most (1 + stretch) d long, at most sharing * d in common with the shortest route,
+// and every part of it up to plateau * d long must be a shortest path
+#define ALTERNATIVE_MAX_STRETCH 0.25
+#define ALTERNATIVE_MAX_SHARING 0.8
+#define ALTERNATIVE_MIN_PLATEAU 0.25
+
+/**
+ * @struct AlternativeRoute
+ * @brief The shortest route between two locations and the best admissible alternative, as CSR edges.
+ */
+struct AlternativeRoute {
+    bool found = false;                 /**< True if the shortest route exists. */
+    bool foundAlternative = false;      /**< True if an admissible alternative was found. */
+    std::vector<unsigned> shortest;     /**< Edges of the shortest route, in order. */
+    std::vector<unsigned> alternative;  /**< Edges of the alternative, in order. */
+    double alternativeDist = INF;       /**< Length of the alternative in the searched metric. */
+    double sharing = 0;                 /**< Length of the alternative's edges that are also on the shortest route. */
+    double plateau = 0;                 /**< Length of the plateau the alternative goes through. */
+};
+
+/**
+ * @brief Computes the shortest route and an alternative with one forward and one backward search.
+ *
+ * The forward search from the origin and the backward search from the destination both stop at
+ * (1 + ALTERNATIVE_MAX_STRETCH) times the shortest distance d. A plateau is a maximal chain of edges that
+ * lie on both trees; each gives the via route origin -> plateau start (forward tree), the plateau,
+ * plateau end -> destination (backward tree). A via route is admissible if:
+ * - bounded stretch: it is at most (1 + ALTERNATIVE_MAX_STRETCH) d long;
+ * - limited sharing: at most ALTERNATIVE_MAX_SHARING d of it is on the shortest route;
+ * - local optimality: its plateau is at least ALTERNATIVE_MIN_PLATEAU d long. Any part of the route no longer
+ *   than the plateau lies within one of the two trees, so it is a shortest path.
+ * Among the admissible routes, the one minimizing 2 * length + sharing - plateau is chosen.
+ * When the all-pairs table of the map is prepared, the forward tree is read from it, so only the backward search runs.
+ * Starts a new query in the workspace, so the bans of the previous one do not apply.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace whose search trees are used.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param shortest Edges of a shortest route found by another algorithm, to compare the alternatives with;
+ *        nullptr to use the forward tree's, which is the route dijkstraToTarget finds.
+ * @return The routes; result.shortest is the given route when one was passed.
+ * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and edges within the stretched distance
+ *       of either end, plus O(L) per plateau longer than ALTERNATIVE_MIN_PLATEAU d, L = length of its route in edges.
+ */
+AlternativeRoute findAlternativeRoute(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, bool driving,
+                                      const std::vector<unsigned>* shortest = nullptr);
+
+#endif // ALTERNATIVE_ROUTES_H
@@ -6,15 +6,132 @@
  * @brief Declaration for executing route planning in batch mode using input/output files.
  */
 
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "CreatingMap.h"
+#include "RoutePlanningUtils.h"
+#include "SearchWorkspace.h"
+
+#define BATCH_CHUNK_SIZE 4096
+
 /**
- * @brief Processes input file, parses instructions, and performs route planning.
+ * @brief One query block of a batch input file.
+ */
+struct BatchQuery {
+    std::string mode;                                   ///< Value of the `Mode` line.
+    int origin = -1;                                    ///< Source location ID.
+    int destination = -1;                               ///< Destination location ID.
+    int includeNode = -1;                               ///< Location the route must pass through, or -1.
+    int maxWalkTime = -1;                               ///< Maximum walking time of an environmentally friendly route, or -1.
+    int k = -1;                                         ///< Number of fastest routes to list, or -1.
+    std::unordered_set<int> avoidNodes;                 ///< Locations to avoid.
+    std::vector<std::pair<int, int>> avoidSegments;     ///< Segments to avoid.
+    std::vector<int> sources;                           ///< Origins of a travel time matrix query.
+    std::vector<int> targets;                           ///< Destinations of a travel time matrix query.
+    SearchAlgorithm algorithm = SearchAlgorithm::Dijkstra;  ///< Shortest-path search to use.
+    bool hasAlgorithm = false;                          ///< Whether an `Algorithm` line was given.
+
+    bool empty() const;
+};
+
+/**
+ * @brief Reads the query blocks of a batch input one at a time.
+ *
+ * Each line holds one `Label:value` field. Blocks are separated by blank lines; a `Mode` line also starts a new
+ * block when the current one already has a mode. Only the current line is kept in memory, so inputs of any length
+ * can be read from a file or from standard input.
+ */
+class BatchReader {
+public:
+    /**
+     * @brief Creates a reader over a stream.
+     *
+     * @param in Stream holding the batch input; it must outlive the reader.
+     */
+    explicit BatchReader(std::istream& in) : in(in) {}
+
+    /**
+     * @brief Reads the next query block.
+     *
+     * @param query Overwritten with the next query.
+     * @return False once the input holds no more queries.
+     *
+     * @note **Time Complexity:** O(L), where L is the length of the block.
+     */
+    bool next(BatchQuery& query);
+
+private:
+    bool parseLine(BatchQuery& query);
+
+    std::istream& in;
+    std::string line;
+    bool pending = false;   ///< Whether `line` is a `Mode` line that starts the next block.
+};
+
+/**
+ * @brief Plans one batch query and writes its result.
  *
- * @param inputFile Path to input batch instructions.
- * @param outputFile Path to output results.
+ * @param map The loaded map.
+ * @param ws Search workspace of the calling thread.
+ * @param query The query to plan.
+ * @param out Stream receiving the result.
  *
  * @note **Time Complexity:** O((V + E) log V), dominated by route planning algorithm.
  */
-void processInputFile(const std::string& inputFile, const std::string& outputFile);
+void runBatchQuery(const LoadedMap& map, SearchWorkspace& ws, const BatchQuery& query, std::ostream& out);
+
+/**
+ * @brief Plans a list of batch queries on a pool of worker threads sharing the map.
+ *
+ * Queries are handed out by a WorkStealingScheduler, so workers that finish their share early take over part of
+ * the others'.
+ *
+ * @param map The loaded map, only read by the workers.
+ * @param ws Search workspace used by the calling thread; the other workers create their own.
+ * @param queries Queries to plan.
+ * @param threads Number of worker threads (at least 1).
+ * @return The text result of each query, in input order.
+ *
+ * @note **Time Complexity:** O(Q (V + E) log V / T) for Q queries on T threads.
+ */
+std::vector<std::string> runBatchQueries(const LoadedMap& map, SearchWorkspace& ws, const std::vector<BatchQuery>& queries, unsigned threads);
+
+/**
+ * @brief Plans every query of a batch input stream, writing the results as they are ready.
+ *
+ * Queries are read and planned BATCH_CHUNK_SIZE at a time, and the output is flushed after each chunk, so memory
+ * use does not grow with the number of queries. The next chunk is read while the current one is planned, and the
+ * worker threads and their workspaces are kept for the whole stream. Results are written in input order,
+ * separated by a blank line.
+ *
+ * @param in Stream holding the batch input.
+ * @param out Stream receiving the results.
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace used by the calling thread.
+ * @param threads Number of worker threads.
+ * @return Number of queries planned.
+ *
+ * @note **Time Complexity:** O(Q (V + E) log V / T), dominated by route planning algorithm.
+ */
+size_t runBatchStream(std::istream& in, std::ostream& out, const LoadedMap& map, SearchWorkspace& ws, unsigned threads);
+
+/**
+ * @brief Processes input file, parses instructions, and performs route planning.
+ *
+ * @param inputFile Path to input batch instructions, or "-" for standard input.
+ * @param outputFile Path to output results, or "-" for standard output.
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
+ * @param threads Number of worker threads.
+ *
+ * @note **Time Complexity:** O(Q (V + E) log V / T), dominated by route planning algorithm.
+ */
+void processInputFile(const std::string& inputFile, const std::string& outputFile, const LoadedMap& map, SearchWorkspace& ws,
+                      unsigned threads = 1);
 
 
 
@@ -23,10 +140,14 @@ void processInputFile(const std::string& inputFile, const std::string& outputFil
  *
  * Parses route instructions from a file and triggers the appropriate route planning logic.
  *
- * @param inputFile Path to the input file containing route instructions.
- * @param outputFile Path to the output file where results will be written.
- * @note **Time Complexity:** O((V + E) log V), inherited from processInputFile().
+ * @param inputFile Path to the input file containing route instructions, or "-" for standard input.
+ * @param outputFile Path to the output file where results will be written, or "-" for standard output.
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
+ * @param threads Number of worker threads.
+ * @note **Time Complexity:** O(Q (V + E) log V / T), inherited from processInputFile().
  */
-void runBatchMode(const std::string& inputFile, const std::string& outputFile);
+void runBatchMode(const std::string& inputFile, const std::string& outputFile, const LoadedMap& map, SearchWorkspace& ws,
+                  unsigned threads = 1);
 
 #endif // BATCH_MODE_H
@@ -0,0 +1,134 @@
+#ifndef CONTRACTION_HIERARCHY_H
+#define CONTRACTION_HIERARCHY_H
+
+/**
+ * @file ContractionHierarchy.h
+ * @brief Contraction Hierarchies (CH) preprocessing and point-to-point queries over the CSR snapshot.
+ */
+
+#include <vector>
+#include "data_structures/CsrGraph.h"
+#include "Location.h"
+
+struct LoadedMap;
+class SearchWorkspace;
+class SearchTree;
+
+/**
+ * @class ContractionHierarchy
+ * @brief Vertex order plus shortcut arcs for one metric, answering shortest-path queries with two small upward searches.
+ *
+ * Vertices are contracted one by one, cheapest first (twice the edge difference plus the number of contracted neighbours).
+ * Contracting v adds a shortcut u -> w for every pair of neighbours whose shortest path runs through v, unless a
+ * local witness search finds another path that is not longer. A query then only follows arcs towards vertices of
+ * higher rank, from both ends, and shortcuts are unpacked into the original CSR edges.
+ *
+ * Like the other searches, only edges open to driving are used. The hierarchy ignores per-query bans, so
+ * restricted queries must use a plain search instead.
+ */
+class ContractionHierarchy {
+public:
+    /**
+     * @brief Orders the vertices and adds the shortcuts for the given metric.
+     *
+     * @param csr CSR snapshot of the graph.
+     * @param driving True to use driving times; false to use walking times.
+     * @note **Time Complexity:** Depends on the graph; close to O(V log V) witness searches of bounded size on road networks.
+     */
+    void build(const CsrGraph<Location>& csr, bool driving);
+
+    /**
+     * @brief Checks whether the hierarchy was built.
+     */
+    bool empty() const {
+        return rank.empty();
+    }
+
+    /**
+     * @brief Metric the hierarchy was built for (true for driving times).
+     */
+    bool isDriving() const {
+        return driving;
+    }
+
+    /**
+     * @brief Number of shortcut arcs added by the preprocessing.
+     */
+    unsigned getNumShortcuts() const {
+        return numShortcuts;
+    }
+
+    /**
+     * @brief Rank of a vertex in the contraction order (0 = contracted first).
+     *
+     * @param v Dense index of the vertex.
+     */
+    unsigned getRank(unsigned v) const {
+        return rank[v];
+    }
+
+    /**
+     * @brief Computes a shortest path between two vertices.
+     *
+     * Runs the upward searches in ws.forward and ws.backward, so any previous result in those trees is lost.
+     *
+     * @param ws Workspace whose search trees are used.
+     * @param s Dense index of the origin.
+     * @param t Dense index of the destination.
+     * @param edges Receives the CSR indices of the edges of the path, in order (empty if s == t or no path exists).
+     * @return Length of the path, or INF if no path exists.
+     * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and arcs above s and t in the hierarchy.
+     */
+    double query(SearchWorkspace& ws, unsigned s, unsigned t, std::vector<unsigned>& edges) const;
+
+    /**
+     * @brief Runs a complete upward search from a vertex, as one half of a many-to-many query.
+     *
+     * Every vertex of the search space ends up with its distance from v (or to v), so combining the forward
+     * space of s with the backward space of t gives d(s, t) as the smallest sum over their common vertices.
+     *
+     * @param tree Search tree receiving the distances; the vertices it touches form the search space.
+     * @param v Dense index of the start vertex.
+     * @param forward True to follow arcs away from v (v as origin); false to follow them into v (v as destination).
+     * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and arcs above v in the hierarchy.
+     */
+    void upwardSearch(SearchTree& tree, unsigned v, bool forward) const;
+
+private:
+    /**
+     * @struct Arc
+     * @brief Original edge or shortcut of the hierarchy.
+     */
+    struct Arc {
+        unsigned from;
+        unsigned to;
+        double weight;
+        unsigned edge;      // CSR edge index, or NO_EDGE for a shortcut
+        unsigned first;     // for a shortcut: arc from -> middle
+        unsigned second;    // for a shortcut: arc middle -> to
+    };
+
+    void unpack(unsigned arc, std::vector<unsigned>& edges) const;
+
+    bool driving = false;
+    unsigned numShortcuts = 0;
+    std::vector<unsigned> rank;
+    std::vector<Arc> arcs;
+    std::vector<unsigned> upOffsets;    // arcs leaving v towards higher ranks: upArcs[upOffsets[v] .. upOffsets[v + 1])
+    std::vector<unsigned> upArcs;
+    std::vector<unsigned> downOffsets;  // arcs entering v from higher ranks: downArcs[downOffsets[v] .. downOffsets[v + 1])
+    std::vector<unsigned> downArcs;
+};
+
+/**
+ * @brief Builds the contraction hierarchies of the map for the walking and the driving metric.
+ *
+ * Not needed before queries, which build the hierarchy they use on first use (see LoadedMap::contractionHierarchy);
+ * useful to keep the preprocessing out of their timings.
+ *
+ * @param map The loaded map; its hierarchies are filled.
+ * @note **Time Complexity:** Two ContractionHierarchy::build calls.
+ */
+void prepareHierarchies(LoadedMap& map);
+
+#endif // CONTRACTION_HIERARCHY_H
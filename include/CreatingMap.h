@@ -7,17 +7,148 @@
  */
 
 #include <iostream>
+#include <mutex>
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include "../include/Location.h"
 #include "data_structures/Graph.h"
+#include "data_structures/CsrGraph.h"
+#include "data_structures/FrozenArray.h"
+#include "MappedFile.h"
+#include "Landmarks.h"
+#include "ContractionHierarchy.h"
+#include "CustomizableHierarchy.h"
+#include "AllPairsTable.h"
+
+// Data files read by createMap, relative to the working directory
+#define LOCATIONS_FILE "../data/Locations.csv"
+#define DISTANCES_FILE "../data/Distances.csv"
+#define COORDINATES_FILE "../data/Coordinates.csv"
+#define MAP_FILE "../data/Map.bin"
+
+// Largest edge weight for which Dijkstra may use a bucket queue (one bucket per possible weight)
+#define MAX_BUCKET_WEIGHT 65535
+
+/**
+ * @struct LocationId
+ * @brief Entry of the location ID index: a location ID and the dense index of its vertex.
+ */
+struct LocationId {
+    int id;             /**< Location ID. */
+    unsigned index;     /**< Dense vertex index. */
+};
 
 /**
- * @brief Global map associating location IDs with their corresponding vertex pointers in the graph.
+ * @struct LoadedMap
+ * @brief City map loaded once per process and shared by every route query.
  *
- * This is used across the project to access graph nodes directly by ID.
+ * Built either from the CSV data files, through a Graph, or straight from a binary map file (see MapFile.h),
+ * so the data is only read at startup instead of once per request. The routing algorithms run over the frozen
+ * CSR snapshot, addressing vertices by their dense index; locations are found by ID or code through two sorted
+ * indices. When the map comes from a map file, the CSR arrays and the indices point into the mapped file and
+ * the graph is left empty.
  */
-extern std::unordered_map<int, Vertex<Location>*> idmap;
+struct LoadedMap {
+    MappedFile file;                                    /**< Map file the snapshot and indices point into, if loaded from one. */
+    Graph<Location> graph;                              /**< Graph holding every location and road segment (empty if loaded from a map file). */
+    CsrGraph<Location> csr;                             /**< Frozen CSR snapshot of the graph used for routing. */
+    FrozenArray<LocationId> ids;                        /**< Location IDs with their dense vertex index, sorted by ID. */
+    FrozenArray<unsigned> codes;                        /**< Dense vertex indices sorted by location code. */
+    double maxDrivingSpeed = 0;                         /**< Fastest driving speed of any edge, in meters per time unit (0 if unknown). */
+    double maxWalkingSpeed = 0;                         /**< Fastest walking speed of any edge, in meters per time unit (0 if unknown). */
+    bool integralWeights[2] = {false, false};           /**< Whether every open edge weight is a small non-negative integer, per metric (index 1 = driving). */
+    unsigned maxWeight[2] = {0, 0};                     /**< Largest open edge weight per metric, when its weights are integral. */
+    LandmarkTable landmarks;                            /**< Landmark distances for ALT search (empty until prepareLandmarks). */
+    mutable ContractionHierarchy hierarchy[2];          /**< Contraction hierarchy per metric, index 1 = driving (empty until first needed, see contractionHierarchy()). */
+    mutable CustomizableHierarchy customizable;         /**< Metric-independent hierarchy for restricted queries (empty until first needed, see customizableHierarchy()). */
+    AllPairsTable allPairs;                             /**< Travel times and paths between all pairs of locations (empty unless prepareAllPairsTable). */
+
+    LoadedMap() = default;
+    LoadedMap(const LoadedMap&) = delete;
+    LoadedMap& operator=(const LoadedMap&) = delete;
+
+    /**
+     * @brief Checks whether a location with the given ID was loaded.
+     *
+     * @param id Location ID.
+     * @return True if the location exists in the map.
+     */
+    bool contains(int id) const {
+        return indexOf(id) >= 0;
+    }
+
+    /**
+     * @brief Returns the dense vertex index of the location with the given ID.
+     *
+     * @param id Location ID.
+     * @return Index of the vertex in the CSR snapshot, or -1 if the location does not exist.
+     * @note **Time Complexity:** O(1) when the IDs have no gaps, O(log N) otherwise.
+     */
+    int indexOf(int id) const;
+
+    /**
+     * @brief Returns the dense vertex index of the location with the given code.
+     *
+     * @param code Location code, as used in the data files.
+     * @return Index of the vertex in the CSR snapshot, or -1 if the location does not exist.
+     * @note **Time Complexity:** O(log N).
+     */
+    int indexOfCode(std::string_view code) const;
+
+    /**
+     * @brief Returns the location ID of the vertex with the given dense index.
+     *
+     * @param index Dense vertex index.
+     */
+    int idOf(unsigned index) const {
+        return csr.getInfo(index).id;
+    }
+
+    /**
+     * @brief Checks whether every location has coordinates and a speed bound exists for the given metric,
+     * so that straight-line distances give a lower bound on travel times.
+     *
+     * @param driving True for driving times; false for walking times.
+     */
+    bool hasSpeedBound(bool driving) const {
+        return (driving ? maxDrivingSpeed : maxWalkingSpeed) > 0;
+    }
+
+    /**
+     * @brief Returns the contraction hierarchy of a metric, building it the first time it is needed.
+     *
+     * Only `ch` queries and large travel time matrices use a hierarchy, so it is not built at startup.
+     * Safe to call from several threads: the first caller builds it while the others wait.
+     *
+     * @param driving True for driving times; false for walking times.
+     * @note **Time Complexity:** One ContractionHierarchy::build on the first call per metric, O(1) afterwards.
+     */
+    const ContractionHierarchy& contractionHierarchy(bool driving) const;
+
+    /**
+     * @brief Returns the customizable hierarchy, building and customizing it for both metrics the first time it is needed.
+     *
+     * Only `cch` queries use it, so it is not built at startup. Safe to call from several threads.
+     *
+     * @note **Time Complexity:** One CustomizableHierarchy::build and two customizations on the first call, O(1) afterwards.
+     */
+    const CustomizableHierarchy& customizableHierarchy() const;
+
+    /**
+     * @brief Checks whether every edge weight of the given metric is a small non-negative integer,
+     * so that Dijkstra can use a bucket queue instead of a comparison heap.
+     *
+     * @param driving True for driving times; false for walking times.
+     */
+    bool hasIntegralWeights(bool driving) const {
+        return integralWeights[driving];
+    }
+
+private:
+    mutable std::once_flag hierarchyBuilt[2];           /**< Guards the first build of each hierarchy. */
+    mutable std::once_flag customizableBuilt;           /**< Guards the first build of the customizable hierarchy. */
+};
 
 /**
  * @brief Reads location data from file and adds vertices to the graph.
@@ -26,29 +157,84 @@ extern std::unordered_map<int, Vertex<Location>*> idmap;
  *
  * @param map Graph to populate with location vertices.
  * @param locations Map to store references to vertices using location codes.
+ * @param idmap Map to store references to vertices using location IDs.
+ * @param path Path to the locations file.
  * @note **Time Complexity:** O(N), where N is number of locations.
  */
-void readLocations(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations);
+void readLocations(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations,
+                   std::unordered_map<int, Vertex<Location>*>& idmap, const std::string& path = LOCATIONS_FILE);
 
 /**
  * @brief Reads distance data from file and adds edges to the graph.
  *
  * Adds bidirectional edges with driving and walking times between known locations.
+ * Large files are parsed in chunks on several threads; the edges are added in file order.
  *
  * @param map Graph to populate with edges.
  * @param locations Map of location codes to existing vertex pointers.
- * @note **Time Complexity:** O(M), where M is number of distance entries.
+ * @param path Path to the distances file.
+ * @param threads Number of parsing threads, 0 for one per core.
+ * @note **Time Complexity:** O(M / T + M), parsing split over T threads, then adding the M edges.
+ */
+void readDistances(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations,
+                   const std::string& path = DISTANCES_FILE, unsigned threads = 0);
+
+/**
+ * @brief Reads the optional coordinates file and attaches the coordinates to the loaded locations.
+ *
+ * @param idmap Map of location IDs to existing vertex pointers.
+ * @param path Path to the coordinates file.
+ * @note **Time Complexity:** O(N), where N is number of coordinate entries.
+ */
+void readCoordinates(std::unordered_map<int, Vertex<Location>*>& idmap, const std::string& path = COORDINATES_FILE);
+
+/**
+ * @brief Builds the location ID and code indices of a map from its CSR snapshot.
+ *
+ * @param map LoadedMap whose CSR snapshot is already built.
+ * @note **Time Complexity:** O(N log N).
+ */
+void indexLocations(LoadedMap& map);
+
+/**
+ * @brief Computes the fastest driving and walking speed over all edges, from the location coordinates.
+ *
+ * @param map LoadedMap whose CSR snapshot is already built.
+ * @note **Time Complexity:** O(N + M).
+ */
+void computeSpeedBounds(LoadedMap& map);
+
+/**
+ * @brief Checks, per metric, whether every edge open to driving has a small non-negative integer weight.
+ *
+ * Weights above MAX_BUCKET_WEIGHT also disable the bucket queue, since it needs one bucket per possible weight.
+ *
+ * @param map LoadedMap whose CSR snapshot is already built.
+ * @note **Time Complexity:** O(M).
+ */
+void detectIntegralWeights(LoadedMap& map);
+
+/**
+ * @brief Populates the map with all location vertices and distance edges parsed from the CSV files.
+ *
+ * Builds the graph, its CSR snapshot used for routing and the location indices, detects integral weights and,
+ * when coordinates are available, computes the speed bounds used by A*.
+ *
+ * @param map LoadedMap object to initialize.
+ * @note **Time Complexity:** O(N log N + M), total locations plus distances.
  */
-void readDistances(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations);
+void createMapFromCsv(LoadedMap& map);
 
 /**
- * @brief Populates the graph with all location vertices and distance edges.
+ * @brief Loads the map, from the binary map file when it is up to date and from the CSV files otherwise.
  *
- * This is the main entry point to initialize the graph using location and distance files.
+ * This is the main entry point to initialize the map; it is meant to be called once at startup, and the
+ * resulting map is then shared by all queries. After parsing the CSV files, the map file is (re)written,
+ * so later starts map it instead of parsing.
  *
- * @param map Graph object to initialize.
- * @note **Time Complexity:** O(N + M), total locations plus distances.
+ * @param map LoadedMap object to initialize.
+ * @note **Time Complexity:** O(N) from the map file; see createMapFromCsv otherwise.
  */
-void createMap(Graph<Location>& map);
+void createMap(LoadedMap& map);
 
 #endif // CREATINGMAP_H
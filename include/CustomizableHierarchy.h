@@ -0,0 +1,175 @@
+#ifndef CUSTOMIZABLE_HIERARCHY_H
+#define CUSTOMIZABLE_HIERARCHY_H
+
+/**
+ * @file CustomizableHierarchy.h
+ * @brief Customizable Contraction Hierarchies (CCH): a metric-independent hierarchy whose weights can be
+ * re-applied quickly, used to guide searches with per-query bans.
+ */
+
+#include <utility>
+#include <vector>
+#include "data_structures/CsrGraph.h"
+#include "Location.h"
+
+struct LoadedMap;
+class SearchWorkspace;
+
+// Parts of the nested dissection with at most this many vertices are not split further
+#define DISSECTION_LEAF_SIZE 16
+
+/**
+ * @class PotentialCache
+ * @brief Distances to the destination of the current query computed from a CustomizableHierarchy, per vertex.
+ *
+ * Each distance is computed the first time the search asks for it. Entries are only valid when their stamp
+ * matches the current epoch, so starting a new query just bumps the epoch.
+ */
+class PotentialCache {
+public:
+    /**
+     * @brief Starts a new query, sizing the cache for the given number of vertices if needed.
+     *
+     * @param numVertices Number of vertices of the hierarchy.
+     * @note **Time Complexity:** O(1) amortized.
+     */
+    void reset(size_t numVertices);
+
+    /**
+     * @brief Checks whether the distance of a vertex was computed in the current query.
+     *
+     * @param v Dense index of the vertex.
+     */
+    bool has(unsigned v) const {
+        return stamp[v] == epoch;
+    }
+
+    /**
+     * @brief Stores the distance of a vertex for the current query.
+     *
+     * @param v Dense index of the vertex.
+     * @param dist Distance to the destination.
+     */
+    void set(unsigned v, double dist) {
+        stamp[v] = epoch;
+        dists[v] = dist;
+    }
+
+    /**
+     * @brief Distance of a vertex to the destination (only valid if has(v)).
+     */
+    double get(unsigned v) const {
+        return dists[v];
+    }
+
+    std::vector<unsigned> pending;      /**< Ancestors whose distance is being computed, kept to reuse its capacity. */
+
+private:
+    std::vector<double> dists;
+    std::vector<unsigned> stamp;
+    unsigned epoch = 0;
+};
+
+/**
+ * @class CustomizableHierarchy
+ * @brief Contraction order and shortcut topology that do not depend on the weights, plus customized weights per metric.
+ *
+ * build() orders dead ends and chains of degree-2 vertices first, then the rest of the road topology by nested
+ * dissection: a small set of vertices (a separator) splitting it in two comes last, and each side is ordered the
+ * same way. It then eliminates them in that
+ * order, adding every fill-in edge, so the hierarchy is valid for any weights. customize() computes the weight of
+ * each arc, in both directions, from its lower triangles.
+ *
+ * The upper neighbours of a vertex are all ancestors of it in the elimination tree (whose parent links go to the
+ * lowest upper neighbour), so the distance from any vertex to a destination t, without bans, is the best path
+ * going up from the vertex and down to t through a common ancestor. A restricted query uses these distances as
+ * the estimate of an A* search over the road graph: bans only make routes longer, so the estimate is a lower bound,
+ * and it is exact wherever the bans do not matter. The ancestors of t are searched once (searchTo()); the
+ * distance of any other vertex is computed from its upper neighbours when the search first asks for it (potential()).
+ *
+ * Only edges open to driving are part of the topology, like in the other searches.
+ */
+class CustomizableHierarchy {
+public:
+    /**
+     * @brief Computes the metric-independent contraction order and the shortcut topology.
+     *
+     * @param csr CSR snapshot of the graph.
+     * @note **Time Complexity:** O((V + E) log V) for the order, plus O(sum of squared upward degrees) for the fill-in.
+     */
+    void build(const CsrGraph<Location>& csr);
+
+    /**
+     * @brief Applies the weights of one metric to the hierarchy.
+     *
+     * @param csr CSR snapshot of the graph the hierarchy was built for.
+     * @param driving True to use driving times; false to use walking times.
+     * @note **Time Complexity:** O(T), T = number of triangles of the hierarchy.
+     */
+    void customize(const CsrGraph<Location>& csr, bool driving);
+
+    /**
+     * @brief Checks whether the hierarchy was built and customized for the given metric.
+     *
+     * @param driving True for driving times; false for walking times.
+     */
+    bool isCustomized(bool driving) const {
+        return !up[driving].empty();
+    }
+
+    /**
+     * @brief Number of arcs (original edges and shortcuts, counted once per vertex pair).
+     */
+    unsigned getNumArcs() const {
+        return arcLow.size();
+    }
+
+    /**
+     * @brief Starts a query towards a destination: searches the downward arcs from it through its ancestors
+     * into ws.backward, and clears the potentials of ws.
+     *
+     * @param ws Workspace of the query.
+     * @param t Dense index of the destination.
+     * @param driving True to use driving times; false to use walking times.
+     * @note **Time Complexity:** O(U), U = number of arcs leaving the ancestors of t.
+     */
+    void searchTo(SearchWorkspace& ws, unsigned t, bool driving) const;
+
+    /**
+     * @brief Distance from a vertex to the destination of searchTo(), ignoring the bans of the workspace.
+     *
+     * @param ws Workspace of the query.
+     * @param v Dense index of the vertex.
+     * @param driving True to use driving times; false to use walking times.
+     * @return The distance, or INF if the destination cannot be reached even without bans.
+     * @note **Time Complexity:** O(U) for the U arcs leaving the ancestors of v not asked for yet in this query.
+     */
+    double potential(SearchWorkspace& ws, unsigned v, bool driving) const;
+
+private:
+    std::vector<unsigned> dissectionOrder(const std::vector<std::vector<unsigned>>& adj, const std::vector<unsigned>& core) const;
+    unsigned findArc(unsigned a, unsigned b) const;
+
+    std::vector<unsigned> rank;         // position of each vertex in the elimination order
+    std::vector<unsigned> treeParent;   // lowest upper neighbour of each vertex (elimination tree), or NO_EDGE for a root
+    std::vector<unsigned> upOffsets;    // arcs to higher-ranked neighbours of v: [upOffsets[v], upOffsets[v + 1]), sorted by head
+    std::vector<unsigned> upHeads;      // higher endpoint of each arc; the arc index is the position in this array
+    std::vector<unsigned> arcLow;       // lower endpoint of each arc
+    std::vector<unsigned> triangleOffsets;  // lower triangles of each arc: [triangleOffsets[a], triangleOffsets[a + 1])
+    std::vector<std::pair<unsigned, unsigned>> triangles;   // arcs (w, low) and (w, high) for a vertex w below both endpoints
+    std::vector<double> up[2];          // customized weight low -> high, per metric (index 1 = driving)
+    std::vector<double> down[2];        // customized weight high -> low, per metric
+};
+
+/**
+ * @brief Builds the customizable hierarchy of the map and customizes it for both metrics.
+ *
+ * Not needed before queries, which build the hierarchy on first use (see LoadedMap::customizableHierarchy);
+ * useful to keep the preprocessing out of their timings.
+ *
+ * @param map The loaded map; its customizable hierarchy is filled.
+ * @note **Time Complexity:** One CustomizableHierarchy::build and two customize calls.
+ */
+void prepareCustomizableHierarchy(LoadedMap& map);
+
+#endif // CUSTOMIZABLE_HIERARCHY_H
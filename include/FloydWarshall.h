@@ -0,0 +1,106 @@
+#ifndef FLOYD_WARSHALL_H
+#define FLOYD_WARSHALL_H
+
+/**
+ * @file FloydWarshall.h
+ * @brief Dense all-pairs travel times with a blocked, vectorized Floyd-Warshall algorithm.
+ */
+
+#include <cstddef>
+#include <vector>
+#include "data_structures/CsrGraph.h"
+#include "Location.h"
+
+// Side of the square tiles, in distances: three 64 x 64 tiles of doubles (96 KB) stay in the L2 cache
+#define FLOYD_WARSHALL_BLOCK 64
+
+/**
+ * @class DistanceMatrix
+ * @brief Square matrix of travel times in one contiguous, cache-line aligned, row-major buffer.
+ *
+ * The matrix is padded to a multiple of FLOYD_WARSHALL_BLOCK rows and columns holding INF, so the blocked
+ * algorithm works on whole tiles. Every row starts on a cache line, and rows are one cache line longer than
+ * that, so the rows of a tile do not all map to the same cache sets when the size is a power of two.
+ */
+class DistanceMatrix {
+public:
+    /**
+     * @brief Creates an n x n matrix with zeros on the diagonal and INF elsewhere.
+     *
+     * @param n Number of vertices.
+     * @note **Time Complexity:** O(N^2), N = n rounded up to a multiple of FLOYD_WARSHALL_BLOCK.
+     */
+    explicit DistanceMatrix(unsigned n);
+    DistanceMatrix(const DistanceMatrix&) = delete;
+    DistanceMatrix& operator=(const DistanceMatrix&) = delete;
+    DistanceMatrix(DistanceMatrix&&) = default;     // a moved vector keeps its storage, so cells stays valid
+
+    unsigned size() const { return numVertex; }
+
+    /**
+     * @brief Number of rows and columns including the padding, a multiple of FLOYD_WARSHALL_BLOCK.
+     */
+    std::size_t getPaddedSize() const { return padded; }
+
+    /**
+     * @brief Number of distances between the starts of two rows.
+     */
+    std::size_t getStride() const { return stride; }
+
+    double* row(unsigned i) { return cells + i * stride; }
+    const double* row(unsigned i) const { return cells + i * stride; }
+    double& at(unsigned i, unsigned j) { return cells[i * stride + j]; }
+    double at(unsigned i, unsigned j) const { return cells[i * stride + j]; }
+
+private:
+    unsigned numVertex;
+    std::size_t padded;
+    std::size_t stride;
+    std::vector<double> storage;    // padded cells plus room to align them
+    double* cells;                  // first cell, on a 64-byte boundary inside storage
+};
+
+/**
+ * @brief Creates the distance matrix of the direct road segments of a graph.
+ *
+ * Entry (u, v) is the cheapest segment from u to v. Like the searches, only segments open to driving are used.
+ *
+ * @param csr CSR snapshot of the graph.
+ * @param driving True for driving times; false for walking times.
+ * @return The matrix, ready for floydWarshall().
+ * @note **Time Complexity:** O(V^2 + E).
+ */
+DistanceMatrix segmentMatrix(const CsrGraph<Location>& csr, bool driving);
+
+/**
+ * @brief Replaces every entry by the shortest travel time, with the textbook triple loop.
+ *
+ * Reference implementation for the blocked version; one thread, no tiling and no explicit vectorization.
+ *
+ * @param matrix Matrix of segment times; receives the shortest travel times.
+ * @note **Time Complexity:** O(V^3).
+ */
+void floydWarshallReference(DistanceMatrix& matrix);
+
+/**
+ * @brief Replaces every entry by the shortest travel time, with the blocked Floyd-Warshall algorithm.
+ *
+ * For each diagonal tile k, in order: the tile is closed over itself, then the tiles of row k and column k
+ * are updated through it, then every other tile (i, j) is updated from tiles (i, k) and (k, j). The tiles of
+ * the last two phases are independent and are spread over a work-stealing pool. The tile kernel uses AVX2
+ * when the processor supports it (checked at run time), and a portable loop otherwise.
+ * The result is identical to floydWarshallReference() when the times are whole numbers (as in the bundled data);
+ * otherwise the sums may be rounded differently in the last bit.
+ *
+ * @param matrix Matrix of segment times; receives the shortest travel times.
+ * @param threads Number of worker threads (at least 1).
+ * @note **Time Complexity:** O(V^3 / T) for T threads.
+ */
+void floydWarshall(DistanceMatrix& matrix, unsigned threads = 1);
+
+/**
+ * @brief Checks whether floydWarshall() runs its AVX2 kernel on this processor.
+ */
+bool floydWarshallUsesAvx2();
+
+#endif // FLOYD_WARSHALL_H
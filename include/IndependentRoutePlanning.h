@@ -3,6 +3,9 @@
 
 #include <vector>
 #include <iostream>
+#include "CreatingMap.h"
+#include "SearchWorkspace.h"
+#include "RoutePlanningUtils.h"
 
 /**
  * @file IndependentRoutePlanning.h
@@ -24,18 +27,35 @@ struct IndependentRoutesResult {
     std::vector<int> altPath;           /**< Node sequence of the alternative route. */
 };
 
+/**
+ * @struct RankedRoutesResult
+ * @brief Structure that stores the K fastest routes between two locations.
+ */
+struct RankedRoutesResult {
+    bool origExists = true;                 /**< Indicates if the origin ID exists. */
+    bool destExists = true;                 /**< Indicates if the destination ID exists. */
+    std::vector<std::vector<int>> paths;    /**< Node sequence of each route, fastest first. */
+    std::vector<double> times;              /**< Duration of each route. */
+};
+
 /**
  * @brief Calculates the fastest route between two points and, optionally, an alternative route.
  *
- * Uses Dijkstra's algorithm to compute the shortest path and an alternative one that avoids the best path.
+ * Computes the shortest path and, with @p doAltPath, an alternative chosen among the plateaus of one forward
+ * and one backward search (see findAlternativeRoute): at most 25% slower, sharing at most 80% of the fastest
+ * route, and made of shortest paths over any stretch up to a quarter of the fastest route's length.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @param origin The ID of the origin location.
  * @param destination The ID of the destination location.
  * @param doAltPath If true, also calculates the alternative route.
+ * @param algorithm Search algorithm used for the fastest route.
  * @return A struct containing the results of the route calculation.
  * @note **Time Complexity:** O((N + M) log N), where N = nodes, M = edges.
  */
-IndependentRoutesResult planFastestRoute(int origin, int destination, bool doAltPath);
+IndependentRoutesResult planFastestRoute(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, bool doAltPath,
+                                         SearchAlgorithm algorithm = SearchAlgorithm::Dijkstra);
 
 /**
  * @brief Outputs the result of the fastest and alternative routes to the given output stream.
@@ -49,4 +69,32 @@ IndependentRoutesResult planFastestRoute(int origin, int destination, bool doAlt
 void outputIndependentRouteResult(const IndependentRoutesResult& result,
                                    std::ostream& out, int origin, int destination);
 
+/**
+ * @brief Calculates up to K distinct loopless routes between two points, fastest first.
+ *
+ * Routes are ranked with the metric planFastestRoute() searches with (see kShortestPaths), and the first one is
+ * its best route; fewer than K are returned when no more routes exist.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
+ * @param origin The ID of the origin location.
+ * @param destination The ID of the destination location.
+ * @param k Maximum number of routes.
+ * @return A struct containing the routes.
+ * @note **Time Complexity:** O((N + M) log N) for one reverse search, plus at most K * L guided spur searches,
+ *       L = nodes in a route.
+ */
+RankedRoutesResult planKFastestRoutes(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, unsigned k);
+
+/**
+ * @brief Outputs the K fastest routes to the given output stream, one `Route<i>` line each.
+ *
+ * @param result Structure containing the routes.
+ * @param out Output stream (e.g., std::cout or file stream).
+ * @param origin The ID of the origin location.
+ * @param destination The ID of the destination location.
+ * @note **Time Complexity:** O(K * N), where N = nodes in a route.
+ */
+void outputRankedRoutesResult(const RankedRoutesResult& result, std::ostream& out, int origin, int destination);
+
 #endif // INDEPENDENT_ROUTE_PLANNING_H
@@ -0,0 +1,52 @@
+#ifndef K_SHORTEST_PATHS_H
+#define K_SHORTEST_PATHS_H
+
+/**
+ * @file KShortestPaths.h
+ * @brief The K shortest loopless routes between two locations (Yen's algorithm).
+ */
+
+#include <vector>
+#include "CreatingMap.h"
+#include "SearchWorkspace.h"
+
+/**
+ * @struct RankedRoute
+ * @brief One of the K shortest routes between two locations, as CSR edges.
+ */
+struct RankedRoute {
+    std::vector<unsigned> edges;    /**< Edges of the route, in order. */
+    double dist = 0;                /**< Length of the route in the searched metric. */
+    unsigned deviation = 0;         /**< Index of the first edge where it leaves the route it was derived from. */
+};
+
+/**
+ * @brief Computes the K shortest loopless routes between two locations, shortest first.
+ *
+ * Yen's algorithm: route i + 1 is the shortest candidate that follows a prefix (the root) of one of the first
+ * i routes up to a spur vertex, then leaves it by an edge that no accepted route with the same root takes,
+ * without going back through the root. Two things keep the spur searches cheap:
+ * - one reverseDijkstra() from the destination gives the exact distance of every vertex to it. When the tree
+ *   path of a spur vertex avoids the banned edges and the root, it is the spur path and no search runs;
+ *   otherwise guidedSearch() uses those distances as its estimate;
+ * - a route is only deviated from at or after the edge where it left its parent (Lawler's rule), since the
+ *   earlier spur vertices were already tried with the same roots.
+ * Bans and ignored vertices live in the workspace, so each spur search only resets epochs.
+ * Among later routes of equal length, the one whose edge indices compare lower comes first.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace whose search trees are used; starts a new query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param k Maximum number of routes.
+ * @param driving True to use driving times; false to use walking times.
+ * @param shortest Edges of a shortest route found by another search, to use as the first route;
+ *        nullptr to use the reverse tree path from the origin.
+ * @return Up to k routes, in increasing length; empty if the destination cannot be reached.
+ * @note **Time Complexity:** O((V + E) log V) for the reverse search, plus at most K * L spur searches,
+ *       L = number of edges of a route, each settling far fewer vertices than Dijkstra in practice.
+ */
+std::vector<RankedRoute> kShortestPaths(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination,
+                                        unsigned k, bool driving, const std::vector<unsigned>* shortest = nullptr);
+
+#endif // K_SHORTEST_PATHS_H
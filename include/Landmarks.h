@@ -0,0 +1,116 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+/**
+ * @file Landmarks.h
+ * @brief Landmark distance tables for ALT search (A*, Landmarks and Triangle inequality).
+ */
+
+#include <string>
+#include <vector>
+#include "data_structures/CsrGraph.h"
+#include "Location.h"
+
+struct LoadedMap;
+class SearchWorkspace;
+
+/**
+ * @class LandmarkTable
+ * @brief Exact distances from and to a small set of landmark vertices, for the driving and the walking metric.
+ *
+ * By the triangle inequality, d(L, t) - d(L, v) and d(v, L) - d(t, L) are lower bounds on d(v, t) for any
+ * landmark L. Taking the largest of them over all landmarks gives a consistent A* potential that needs no
+ * coordinates. Bans only make paths longer, so the bounds stay valid in restricted queries.
+ *
+ * Like the search algorithms, the tables only use edges that are open to driving, and are indexed by dense vertex index.
+ */
+class LandmarkTable {
+public:
+    /**
+     * @brief Selects the landmarks and computes the distance tables for both metrics.
+     *
+     * Landmarks are picked by farthest selection: each new landmark is the vertex farthest from the ones already chosen.
+     *
+     * @param map The loaded map.
+     * @param ws Workspace used to run the searches.
+     * @param count Number of landmarks per metric.
+     * @note **Time Complexity:** O(K (V + E) log V), K = number of landmarks.
+     */
+    void build(const LoadedMap& map, SearchWorkspace& ws, unsigned count);
+
+    /**
+     * @brief Writes the tables to a binary file, tagged with a fingerprint of the graph.
+     *
+     * @param path Path of the file.
+     * @param csr Graph the tables were computed for.
+     * @return True if the file was written.
+     */
+    bool save(const std::string& path, const CsrGraph<Location>& csr) const;
+
+    /**
+     * @brief Reads the tables from a binary file written by save().
+     *
+     * @param path Path of the file.
+     * @param csr Graph the tables must belong to.
+     * @param count Number of landmarks expected per metric.
+     * @return True if the file exists, matches the graph and holds the expected number of landmarks.
+     */
+    bool load(const std::string& path, const CsrGraph<Location>& csr, unsigned count);
+
+    /**
+     * @brief Checks whether the tables are available for the given metric.
+     *
+     * @param driving True for driving times; false for walking times.
+     */
+    bool available(bool driving) const {
+        return !landmarks[driving].empty();
+    }
+
+    /**
+     * @brief Number of landmarks of the given metric.
+     *
+     * @param driving True for driving times; false for walking times.
+     */
+    unsigned size(bool driving) const {
+        return landmarks[driving].size();
+    }
+
+    /**
+     * @brief Lower bound on the distance from one vertex to another.
+     *
+     * @param driving True for driving times; false for walking times.
+     * @param v Dense index of the start vertex.
+     * @param t Dense index of the target vertex.
+     * @return A value never greater than the true distance (0 if nothing is known).
+     * @note **Time Complexity:** O(K), K = number of landmarks.
+     */
+    double lowerBound(bool driving, unsigned v, unsigned t) const;
+
+private:
+    std::vector<unsigned> landmarks[2];     // landmark vertices, per metric (index 1 = driving)
+    std::vector<double> from[2];            // from[m][v * K + k] = d(landmark k, v)
+    std::vector<double> to[2];              // to[m][v * K + k] = d(v, landmark k)
+};
+
+/**
+ * @brief Loads the landmark tables of the map, or computes them and stores them for the next run.
+ *
+ * @param map The loaded map; its landmark table is filled.
+ * @param ws Workspace used to run the preprocessing searches.
+ * @param path Path of the landmark file, kept next to the data files.
+ * @param count Number of landmarks per metric.
+ * @note **Time Complexity:** O(V + E) when the file is up to date; O(K (V + E) log V) otherwise.
+ */
+void prepareLandmarks(LoadedMap& map, SearchWorkspace& ws, const std::string& path = "../data/Landmarks.bin",
+                      unsigned count = 16);
+
+/**
+ * @brief Fingerprint of the structure and weights of a graph, used to detect stale preprocessing files.
+ *
+ * @param csr Graph to fingerprint.
+ * @return 64-bit hash of the vertex IDs and of every edge.
+ * @note **Time Complexity:** O(V + E).
+ */
+unsigned long long graphFingerprint(const CsrGraph<Location>& csr);
+
+#endif // LANDMARKS_H
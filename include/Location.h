@@ -8,6 +8,9 @@
 
 #include <string>
 #include <utility>  // For std::move
+#include <functional>  // For std::hash
+#include <cmath>
+#include <algorithm>  // For std::min
 
 /**
  * @struct Location
@@ -18,6 +21,9 @@ struct Location {
     int id;              /**< Unique identifier of the location. */
     std::string code;    /**< Code used to identify the location in data files. */
     int parking;         /**< Indicates if location has parking (1 = yes, 0 = no). */
+    bool hasCoordinates = false;    /**< True if latitude and longitude are known. */
+    double latitude = 0;            /**< Latitude in degrees (only valid if hasCoordinates). */
+    double longitude = 0;           /**< Longitude in degrees (only valid if hasCoordinates). */
 
     /**
      * @brief Equality operator based on the location ID.
@@ -44,6 +50,49 @@ struct Location {
      */
     Location(std::string name, int id, std::string code, int parking)
         : name(std::move(name)), id(id), code(std::move(code)), parking(parking) {}
+
+    /**
+     * @brief Sets the geographical coordinates of the location.
+     *
+     * @param lat Latitude in degrees.
+     * @param lon Longitude in degrees.
+     */
+    void setCoordinates(double lat, double lon) {
+        latitude = lat;
+        longitude = lon;
+        hasCoordinates = true;
+    }
+};
+
+/**
+ * @brief Great-circle (haversine) distance between two locations with coordinates.
+ *
+ * @param a First location.
+ * @param b Second location.
+ * @return Distance in meters.
+ */
+inline double straightLineDistance(const Location& a, const Location& b) {
+    const double earthRadius = 6371000.0;
+    const double toRad = M_PI / 180.0;
+    double dLat = (b.latitude - a.latitude) * toRad;
+    double dLon = (b.longitude - a.longitude) * toRad;
+    double h = std::sin(dLat / 2) * std::sin(dLat / 2) +
+               std::cos(a.latitude * toRad) * std::cos(b.latitude * toRad) * std::sin(dLon / 2) * std::sin(dLon / 2);
+    return 2 * earthRadius * std::asin(std::sqrt(std::min(1.0, h)));
+}
+
+/**
+ * @brief Hash of a Location, consistent with Location::operator== (based on the ID).
+ *
+ * Allows Graph<Location> to look vertices up in O(1).
+ */
+namespace std {
+template <>
+struct hash<Location> {
+    size_t operator()(const Location& location) const noexcept {
+        return hash<int>()(location.id);
+    }
 };
+}
 
 #endif // LOCATION_H
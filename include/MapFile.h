@@ -0,0 +1,61 @@
+#ifndef MAP_FILE_H
+#define MAP_FILE_H
+
+/**
+ * @file MapFile.h
+ * @brief Binary serialization of a loaded map, memory-mapped at startup instead of parsing the CSV files.
+ *
+ * A map file starts with a fixed header: magic, format version, byte order, the size and modification time
+ * of each data file it was written from, the vertex and edge counts, the weight properties detected at load
+ * time and the offset and size of every section. Each section starts on a 64-byte boundary:
+ * - vertex table: ID, parking flag, coordinates and the position of the name and code in the string pool;
+ * - string pool: the names and codes, back to back;
+ * - the CSR arrays: outgoing offsets, sources, targets, driving and walking times, reverse edges,
+ *   incoming offsets and incoming edges;
+ * - location index: (ID, vertex) pairs sorted by ID;
+ * - code index: vertex indices sorted by code.
+ *
+ * Loading checks the header and the section bounds, copies the vertex table into Location objects and
+ * points the CSR snapshot and both indices into the mapping, so nothing is parsed. The mapping is read-only
+ * and shared, so every process mapping the same file shares its pages through the page cache.
+ */
+
+#include <string>
+#include <vector>
+#include "CreatingMap.h"
+
+// Version of the map file layout, bumped whenever the layout changes
+#define MAP_FILE_VERSION 1
+
+/**
+ * @brief Writes a loaded map to a binary map file.
+ *
+ * The file is written next to the target and then renamed over it, so processes that still map an older
+ * version keep a consistent view.
+ *
+ * @param map Map to save, with its CSR snapshot and indices built.
+ * @param path Path of the map file.
+ * @param sources Data files the map was read from; their size and modification time are recorded.
+ * @return True if the file was written.
+ * @note **Time Complexity:** O(N + M).
+ */
+bool saveMapFile(const LoadedMap& map, const std::string& path, const std::vector<std::string>& sources);
+
+/**
+ * @brief Maps a binary map file into a LoadedMap.
+ *
+ * Fails, leaving the map unchanged, if the file is missing, was written by another format version or on a
+ * machine with another byte order, is truncated, fails the consistency checks of its graph arrays and location
+ * indices, records weight or speed bounds that its edges do not have, or if any of the data files changed since
+ * it was written. The caller then reads the CSV files.
+ *
+ * @param map Map to load into; must be empty.
+ * @param path Path of the map file.
+ * @param sources Data files the map file must have been written from.
+ * @return True if the map was loaded.
+ * @note **Time Complexity:** O(N + M): one pass checks the graph arrays and indices, one
+ *       derives the weight and speed bounds again, and the vertex table is copied.
+ */
+bool loadMapFile(LoadedMap& map, const std::string& path, const std::vector<std::string>& sources);
+
+#endif // MAP_FILE_H
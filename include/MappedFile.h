@@ -0,0 +1,59 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/**
+ * @file MappedFile.h
+ * @brief Read-only view of a whole file, memory-mapped where the platform allows it.
+ */
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief Maps a file read-only into memory so that it can be parsed in place, without copying it line by line.
+ *
+ * On POSIX systems the file is mapped with mmap, so its pages come straight from the page cache and are shared by
+ * every process mapping the same file. Elsewhere, or if mapping fails, the file is read into a buffer instead.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Opens and maps a file, releasing any file mapped before.
+     *
+     * @param path Path to the file.
+     * @param sequential Whether the file will be read once from start to end, so the kernel may read ahead
+     *        aggressively and drop pages behind the reader; false for files that are accessed at random and kept.
+     * @return True if the file could be opened.
+     * @note **Time Complexity:** O(1) when mapped; O(S) when read into a buffer, S = file size.
+     */
+    bool open(const std::string& path, bool sequential = true);
+
+    /**
+     * @brief Releases the mapping.
+     */
+    void close();
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    std::size_t size() const { return length; }
+    bool isOpen() const { return opened; }
+
+private:
+    const char* data = nullptr;
+    std::size_t length = 0;
+    bool opened = false;
+    bool mapped = false;        ///< Whether data points to a mapping rather than into buffer.
+    std::vector<char> buffer;   ///< File contents when the file could not be mapped.
+};
+
+#endif // MAPPED_FILE_H
@@ -9,25 +9,34 @@
 #include "../include/IndependentRoutePlanning.h"
 #include "../include/RestrictedRoutePlanning.h"
 #include "../include/data_structures/Graph.h"
+#include "../include/CreatingMap.h"
+#include "../include/SearchWorkspace.h"
 
 /**
  * @brief Starts the interactive menu loop, allowing the user to select route planning options.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @note **Time Complexity:** O((N + M) log N), governed by route-planning algorithms.
  */
-void handleMenuSelection();
+void handleMenuSelection(const LoadedMap& map, SearchWorkspace& ws);
 
 /**
  * @brief Handles manual input to compute the fastest route.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @note **Time Complexity:** O((N + M) log N), due to internal Dijkstra algorithm calls.
  */
-void planFastestRouteMenu();
+void planFastestRouteMenu(const LoadedMap& map, SearchWorkspace& ws);
 
 /**
  * @brief Handles batch mode input from files to compute fastest routes.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @note **Time Complexity:** O(L + (N + M) log N), L is input file lines.
  */
-void planFastestRouteBatch();
+void planFastestRouteBatch(const LoadedMap& map, SearchWorkspace& ws);
 
 #endif // MENU_H
@@ -9,6 +9,9 @@
 #include <vector>
 #include <unordered_set>
 #include <iostream>
+#include "CreatingMap.h"
+#include "SearchWorkspace.h"
+#include "RoutePlanningUtils.h"
 
 /**
  * @struct RestrictedRoutesResult
@@ -28,18 +31,22 @@ struct RestrictedRoutesResult {
  *
  * Allows ignoring specific nodes and segments, and optionally forces the path to include a certain node.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @param origin ID of the origin node.
  * @param destination ID of the destination node.
  * @param ignoreVertex Set of node IDs to be avoided.
  * @param avoidSegments List of directed edges to be avoided.
  * @param include Optional node ID that must be included in the route (-1 if none).
+ * @param algorithm Search algorithm used for each origin-destination search.
  * @return A RestrictedRoutesResult containing the path and metadata.
  * @note **Time Complexity:** O((N + M) log N), where N = nodes, M = edges.
  */
-RestrictedRoutesResult excludeNodesOrSegments(int origin, int destination,
+RestrictedRoutesResult excludeNodesOrSegments(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination,
                                               const std::unordered_set<int>& ignoreVertex,
                                               const std::vector<std::pair<int, int>>& avoidSegments,
-                                              int include);
+                                              int include,
+                                              SearchAlgorithm algorithm = SearchAlgorithm::Dijkstra);
 
 /**
  * @brief Outputs the restricted route result to a given stream (console or file).
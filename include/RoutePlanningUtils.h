@@ -6,49 +6,344 @@
  * @brief Declarations of utility functions used for route planning with Dijkstra's algorithm and path extraction.
  */
 
+#include <string>
 #include <unordered_set>
 #include "../include/data_structures/Graph.h"
 #include "../include/data_structures/MutablePriorityQueue.h"
 #include "../include/CreatingMap.h"
+#include "../include/SearchWorkspace.h"
+
+/**
+ * @enum SearchAlgorithm
+ * @brief Algorithm used to compute a point-to-point shortest path.
+ */
+enum class SearchAlgorithm {
+    Dijkstra,       /**< Single-source Dijkstra from the origin; a table lookup when the all-pairs table is prepared and the query has no bans. */
+    Bidirectional,  /**< Dijkstra from both ends (outgoing edges from the origin, incoming edges from the destination). */
+    AStar,          /**< Goal-directed search guided by location coordinates; falls back to Dijkstra without them. */
+    ALT,            /**< Goal-directed search guided by landmark distances; falls back to Dijkstra without them. */
+    CH,             /**< Contraction hierarchy query; falls back to Dijkstra when the query has bans. */
+    CCH             /**< Customizable contraction hierarchy query; guides an A* search that applies the bans. */
+};
+
+/**
+ * @brief Parses the name of a search algorithm, as written in batch input files.
+ *
+ * Accepted names (case-insensitive): "dijkstra", "bidirectional", "astar" (or "a*"), "alt", "ch", "cch".
+ *
+ * @param name Name to parse.
+ * @param algorithm Receives the parsed algorithm.
+ * @return True if the name is valid.
+ */
+bool parseSearchAlgorithm(const std::string& name, SearchAlgorithm& algorithm);
 
 /**
  * @brief Attempts to relax an edge during Dijkstra's algorithm.
  *
- * Updates the destination vertex's distance if a shorter path is found through the given edge.
+ * Updates the destination vertex's distance in the search tree if a shorter path is found through the given edge.
  *
- * @param edge Pointer to the edge to relax.
+ * @param csr CSR snapshot of the graph.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree being built.
+ * @param edge CSR index of the edge to relax.
  * @param driving True to use driving time; false to use walking time.
  * @param reverseNeeded True if reverse edges are required for walking path reconstruction.
- * @param ignoreVertex Set of node IDs to ignore during pathfinding.
  * @return True if the relaxation updated the destination's distance.
  */
-bool relax(Edge<Location> *edge, bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex);
+bool relax(const CsrGraph<Location>& csr, const SearchWorkspace& ws, SearchTree& tree, unsigned edge, bool driving, bool reverseNeeded);
 
 /**
  * @brief Executes Dijkstra's algorithm on a graph from a given origin.
  *
- * Initializes distances and predecessors for each vertex and computes shortest paths based on driving or walking cost.
+ * Computes shortest paths over the CSR snapshot based on driving or walking cost. Distances and predecessors
+ * are written to the given search tree, so the map itself is only read.
  *
- * @param g Pointer to the graph.
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result (usually ws.forward).
  * @param origin ID of the origin vertex.
  * @param driving True to use driving times; false to use walking times.
  * @param reverseNeeded True if walking path reconstruction needs reverse edge tracking.
  * @param ignoreVertex Set of vertex IDs to be ignored during computation.
  * @note **Time Complexity:** O((V + E) log V), where V is number of vertices and E is number of edges.
  */
-void dijkstra(const Graph<Location>* g, const int &origin, bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex);
+void dijkstra(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int &origin, bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes Dijkstra's algorithm from a given origin, stopping as soon as the destination is settled.
+ *
+ * The path to the destination is identical to the one a full dijkstra() would produce.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result (usually ws.forward).
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and edges closer to the origin than the destination.
+ */
+void dijkstraToTarget(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+                      bool driving, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes Dijkstra's algorithm from a given origin, stopping once all the targets are settled.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result.
+ * @param origin ID of the origin vertex.
+ * @param targets IDs of the vertices whose distances and paths are needed.
+ * @param driving True to use driving times; false to use walking times.
+ * @param reverseNeeded True if walking path reconstruction needs reverse edge tracking.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and edges closer to the origin than the farthest target.
+ */
+void dijkstraToTargets(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const std::vector<int>& targets,
+                       bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes Dijkstra's algorithm from a given origin, settling only the vertices within a maximum distance.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result.
+ * @param origin ID of the origin vertex.
+ * @param maxDist Largest distance of interest.
+ * @param driving True to use driving times; false to use walking times.
+ * @param reverseNeeded True if walking path reconstruction needs reverse edge tracking.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and edges within maxDist.
+ */
+void dijkstraWithin(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, double maxDist,
+                    bool driving, bool reverseNeeded, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes Dijkstra's algorithm from a given origin past the destination, settling every vertex up to a
+ * stretch of the destination's distance.
+ *
+ * Every vertex whose distance is at most (1 + stretch) times the destination's distance is settled, with its
+ * shortest path in the tree; the path to the destination is the one dijkstraToTarget finds.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param stretch Fraction of the destination's distance searched beyond it.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and edges within the stretched distance.
+ */
+void dijkstraWithinStretch(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+                           double stretch, bool driving, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes an A* search between two vertices, using straight-line distances as the estimate.
+ *
+ * Requires coordinates for every location (see LoadedMap::hasSpeedBound); otherwise runs dijkstraToTarget.
+ * The path found has the same cost as the one found by Dijkstra.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result (usually ws.forward).
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V + E) log V) in the worst case; usually settles far fewer vertices than Dijkstra.
+ */
+void aStar(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+           bool driving, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes an A* search between two vertices, using exact distances to the destination as the estimate.
+ *
+ * The estimate of a vertex is its distance in a tree computed by reverseDijkstra() towards the destination,
+ * without bans. Bans only make paths longer, so the estimate stays a consistent lower bound; where nothing is
+ * banned it is exact, and the search only settles the vertices of the shortest path.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result (usually ws.forward).
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param toDestination Tree of a complete reverseDijkstra() from the destination, in the same metric.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V + E) log V) in the worst case; O(L log L) for a path of L edges that avoids the bans.
+ */
+void guidedSearch(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+                  const SearchTree& toDestination, bool driving, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes an ALT search between two vertices: A* with lower bounds from the landmark tables of the map.
+ *
+ * Requires prepareLandmarks to have been called; otherwise runs dijkstraToTarget.
+ * The path found has the same cost as the one found by Dijkstra.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result (usually ws.forward).
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O(K (V + E) log V) in the worst case, K = number of landmarks; usually settles far fewer vertices than Dijkstra.
+ */
+void altSearch(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, const int& destination,
+               bool driving, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Computes the shortest path between two vertices with the contraction hierarchy of the map.
+ *
+ * The path is stored in ws.forward, like the other searches, so it can be read with getBestPath.
+ * Falls back to dijkstraToTarget when the query has banned edges or ignored vertices. Otherwise builds the
+ * hierarchy of the metric if this is its first use (see LoadedMap::contractionHierarchy).
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the part of the hierarchy above the origin and the destination.
+ */
+void hierarchySearch(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                     const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Computes the shortest path between two vertices with the all-pairs table of the map.
+ *
+ * Unpacks the path from the table, which holds the paths dijkstraToTarget finds, and stores it in ws.forward.
+ * Falls back to dijkstraToTarget when the query has banned edges or ignored vertices, or the table was not prepared.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O(P), P = number of edges of the path.
+ */
+void tableSearch(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                 const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Computes the shortest path between two vertices with the customizable hierarchy of the map.
+ *
+ * Runs A* over the road graph with banned edges and ignored vertices, using the distances to the destination in
+ * the hierarchy (which ignore the bans) as the estimate: where the bans do not matter it is exact, so the search
+ * settles little more than the route itself. The path is stored in ws.forward, like the other searches, so it can
+ * be read with getBestPath.
+ *
+ * @param map The loaded map; its customizable hierarchy is built if this is its first use.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O(S log S) for the S settled vertices, plus O(U) for the U hierarchy arcs leaving the
+ *       ancestors of the vertices reached.
+ */
+void customizableSearch(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                        const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Computes the unpacked shortest path between two vertices with the contraction hierarchy, without bans.
+ *
+ * Returns the path in the same form as getBestPath, but does not ban its edges.
+ *
+ * @param map The loaded map; its hierarchy for the metric is built if this is its first use.
+ * @param ws Workspace whose search trees are used.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param time Reference to accumulate the total driving time of the path.
+ * @return A vector of node IDs from origin to destination, or empty if no path exists.
+ * @note **Time Complexity:** O((V' + E') log V' + P), P = number of edges of the unpacked path.
+ */
+std::vector<int> hierarchyPath(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving, double& time);
+
+/**
+ * @brief Executes Dijkstra's algorithm on the reversed graph, computing the distance from every vertex to a given one.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result; the path of a vertex is its outgoing edge towards the origin.
+ * @param origin ID of the vertex the distances are measured to.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V + E) log V).
+ */
+void reverseDijkstra(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, bool driving, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Executes Dijkstra's algorithm on the reversed graph, settling only the vertices within a maximum distance of a given one.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param tree Search tree that receives the result; the path of a vertex is its outgoing edge towards the origin.
+ * @param origin ID of the vertex the distances are measured to.
+ * @param maxDist Largest distance of interest.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @param forward Optional forward search tree; a vertex is then only expanded if its distance in it plus its
+ *        distance to the origin is at most maxDist. The distances of those vertices stay exact, since every vertex
+ *        on their shortest path to the origin passes the same test; the others may be overestimated.
+ * @note **Time Complexity:** O((V' + E') log V'), V' and E' being the vertices and edges within maxDist.
+ */
+void reverseDijkstraWithin(const LoadedMap& map, SearchWorkspace& ws, SearchTree& tree, const int& origin, double maxDist,
+                           bool driving, const std::unordered_set<int>& ignoreVertex, const SearchTree* forward = nullptr);
+
+/**
+ * @brief Executes a bidirectional Dijkstra search between two vertices.
+ *
+ * Alternates a forward search from the origin (in ws.forward) and a backward search over incoming edges
+ * from the destination (in ws.backward), always expanding the side with the smaller queue key. Stops as soon
+ * as the sum of both queue keys reaches the best origin-destination distance seen so far, then stitches the
+ * backward half of the path into ws.forward so getBestPath() can read it.
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @note **Time Complexity:** O((V + E) log V) in the worst case; usually settles far fewer vertices than dijkstra().
+ */
+void bidirectionalDijkstra(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving, const std::unordered_set<int>& ignoreVertex);
+
+/**
+ * @brief Computes the shortest path between two vertices with the selected algorithm.
+ *
+ * The result is left in ws.forward, ready for getBestPath().
+ *
+ * @param map The loaded map.
+ * @param ws Workspace holding the bans of the current query.
+ * @param origin ID of the origin vertex.
+ * @param destination ID of the destination vertex.
+ * @param driving True to use driving times; false to use walking times.
+ * @param ignoreVertex Set of vertex IDs to be ignored during computation.
+ * @param algorithm Search algorithm to use.
+ * @note **Time Complexity:** O((V + E) log V).
+ */
+void shortestPath(const LoadedMap& map, SearchWorkspace& ws, const int& origin, const int& destination, bool driving,
+                  const std::unordered_set<int>& ignoreVertex, SearchAlgorithm algorithm);
 
 /**
- * @brief Retrieves the shortest path from origin to destination after Dijkstra has been run.
+ * @brief Retrieves the shortest path from origin to destination after Dijkstra (or shortestPath()) has been run.
  *
- * Also computes the total time of the path and marks the used edges as ignored for future calculations.
+ * Reads the forward tree of the workspace. Also computes the total time of the path and bans the used edges
+ * for the remaining searches of the same query.
  *
- * @param g Pointer to the graph.
+ * @param map The loaded map.
+ * @param ws Workspace holding the result of the last forward search.
  * @param origin ID of the starting node.
  * @param dest ID of the destination node.
  * @param time Reference to store the total time of the path.
  * @return Vector of node IDs representing the shortest path.
  */
-std::vector<int> getBestPath(Graph<Location> *g, const int &origin, const int &dest, double &time);
+std::vector<int> getBestPath(const LoadedMap& map, SearchWorkspace& ws, const int &origin, const int &dest, double &time);
 
 #endif
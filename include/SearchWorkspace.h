@@ -0,0 +1,325 @@
+#ifndef SEARCH_WORKSPACE_H
+#define SEARCH_WORKSPACE_H
+
+/**
+ * @file SearchWorkspace.h
+ * @brief Per-query search state kept outside the graph, so a loaded map can serve any number of queries.
+ */
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <utility>
+#include "CreatingMap.h"
+#include "data_structures/BucketQueue.h"
+#include "data_structures/DaryHeap.h"
+#include "data_structures/MutablePriorityQueue.h"
+#include "data_structures/PairingHeap.h"
+
+/**
+ * @enum QueueKind
+ * @brief Priority queue used by the Dijkstra-based searches (dijkstra, dijkstraToTarget, A*, ALT, ...).
+ *
+ * All kinds settle vertices in the same distance order; they only differ in speed and in the order
+ * in which vertices with equal keys are settled.
+ *
+ * In heapBenchmark (full searches, from the bundled data up to a 1M-location grid) the bucket queue is fastest
+ * at every size, 1.4-1.6x faster than the binary queue. Among the comparison heaps no size favours another
+ * one: the 4-ary and 8-ary heaps stay within 12% of the binary queue either way, and the pairing heap is 1.5-1.7x
+ * slower. So the default is Bucket, falling back to Binary, whatever the size of the map.
+ */
+enum class QueueKind {
+    Binary,     /**< MutablePriorityQueue of search tree nodes (the original queue). */
+    FourAry,    /**< Cache-aligned 4-ary heap of (key, index) pairs. */
+    EightAry,   /**< Cache-aligned 8-ary heap of (key, index) pairs. */
+    Pairing,    /**< Pairing heap over vertex indices. */
+    Bucket,     /**< Dial's bucket queue when the weights are small integers (see LoadedMap::hasIntegralWeights), else Binary. */
+    Lazy        /**< Plain binary heap of (key, index) entries without decrease-key: improved vertices are pushed again and stale entries skipped. */
+};
+
+/**
+ * @struct SearchStats
+ * @brief Work counters of the Dijkstra-based searches, accumulated until the caller resets them.
+ */
+struct SearchStats {
+    unsigned long long settled = 0;         /**< Vertices extracted from the queue and scanned. */
+    unsigned long long inserts = 0;         /**< Vertices queued for the first time. */
+    unsigned long long decreases = 0;       /**< Queued vertices whose key improved (a new entry with QueueKind::Lazy). */
+    unsigned long long stalePops = 0;       /**< Outdated entries popped and skipped (QueueKind::Lazy only). */
+
+    /**
+     * @brief Entries added to the queue.
+     *
+     * @param lazy True if the searches used QueueKind::Lazy, where every improvement adds an entry.
+     */
+    unsigned long long pushes(bool lazy) const {
+        return inserts + (lazy ? decreases : 0);
+    }
+
+    /**
+     * @brief Entries removed from the queue, stale ones included.
+     */
+    unsigned long long pops() const {
+        return settled + stalePops;
+    }
+};
+
+/**
+ * @brief Parses a queue name ("binary", "4-ary", "8-ary", "pairing", "bucket" or "lazy", case-insensitive).
+ *
+ * @param name Name to parse.
+ * @param kind Receives the queue kind on success.
+ * @return True if the name was recognised.
+ */
+bool parseQueueKind(const std::string& name, QueueKind& kind);
+
+/**
+ * @brief Name of a queue kind, as accepted by parseQueueKind.
+ */
+const char* queueKindName(QueueKind kind);
+
+/**
+ * @class SearchTree
+ * @brief Distances and parent edges of a single shortest-path search over the CSR snapshot, indexed by dense vertex index.
+ *
+ * Entries are only valid when their stamp matches the current epoch, so starting a new search
+ * just bumps the epoch instead of sweeping every vertex.
+ */
+class SearchTree {
+public:
+    /**
+     * @struct Node
+     * @brief Search state of one vertex. Doubles as the element type of the MutablePriorityQueue.
+     */
+    struct Node {
+        double dist = INF;                  /**< Tentative distance from the search origin. */
+        double key = INF;                   /**< Priority in the queue: dist, plus the heuristic estimate in A*. */
+        unsigned path = NO_EDGE;            /**< CSR index of the edge used to reach the vertex. */
+        unsigned stamp = 0;                 /**< Epoch in which the entry was last written. */
+        int queueIndex = 0;                 /**< Required by MutablePriorityQueue. */
+
+        bool operator<(Node& other) const {
+            return key < other.key;
+        }
+    };
+
+    MutablePriorityQueue<Node> queue;   /**< Priority queue of the search, kept to reuse its capacity. */
+    DaryHeap<4> fourAryHeap;            /**< Queue used instead with QueueKind::FourAry; sized on first use. */
+    DaryHeap<8> eightAryHeap;           /**< Queue used instead with QueueKind::EightAry; sized on first use. */
+    PairingHeap pairingHeap;            /**< Queue used instead with QueueKind::Pairing; sized on first use. */
+    BucketQueue bucketQueue;            /**< Queue used instead with QueueKind::Bucket; sized on first use. */
+    std::vector<std::pair<double, unsigned>> lazyHeap;  /**< Min-heap of (key, index) entries used with QueueKind::Lazy. */
+
+    /**
+     * @brief Resizes the tree to hold state for the given number of vertices.
+     *
+     * @param numVertices Number of vertices in the graph.
+     * @note **Time Complexity:** O(V).
+     */
+    void resize(size_t numVertices);
+
+    /**
+     * @brief Number of vertices the tree was sized for.
+     */
+    size_t size() const {
+        return nodes.size();
+    }
+
+    /**
+     * @brief Starts a new search, invalidating every entry of the previous one.
+     *
+     * @note **Time Complexity:** O(1) amortized; O(V) once every 2^32 searches when the stamps wrap around.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the state of a vertex, initializing it first if it was not touched by the current search.
+     *
+     * @param index Dense index of the vertex.
+     * @return Reference to the vertex state.
+     */
+    Node& touch(int index) {
+        Node& n = nodes[index];
+        if (n.stamp != epoch) {
+            n.dist = INF;
+            n.key = INF;
+            n.path = NO_EDGE;
+            n.stamp = epoch;
+            n.queueIndex = 0;
+            touched.push_back(index);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Distance of a vertex in the current search (INF if it was not reached).
+     *
+     * @param index Dense index of the vertex.
+     */
+    double getDist(int index) const {
+        return nodes[index].stamp == epoch ? nodes[index].dist : INF;
+    }
+
+    /**
+     * @brief CSR index of the edge used to reach a vertex in the current search (NO_EDGE if none).
+     *
+     * @param index Dense index of the vertex.
+     */
+    unsigned getPath(int index) const {
+        return nodes[index].stamp == epoch ? nodes[index].path : NO_EDGE;
+    }
+
+    /**
+     * @brief Dense index of a node returned by the priority queue.
+     *
+     * @param node Pointer to a node owned by this tree.
+     */
+    int indexOf(const Node* node) const {
+        return static_cast<int>(node - nodes.data());
+    }
+
+    /**
+     * @brief Dense indices of all vertices touched by the current search.
+     */
+    const std::vector<int>& getTouched() const {
+        return touched;
+    }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<int> touched;
+    unsigned epoch = 1;
+};
+
+/**
+ * @class SearchWorkspace
+ * @brief Reusable per-query state: a forward and a backward search tree plus the per-query ban sets.
+ *
+ * The loaded map is never modified while routing. Everything a query writes lives here,
+ * so one workspace can be reused for thousands of queries against the same map.
+ */
+class SearchWorkspace {
+public:
+    /**
+     * @brief Creates a workspace sized for the given map.
+     *
+     * @param map The loaded map the workspace will be used with.
+     * @note **Time Complexity:** O(V).
+     */
+    explicit SearchWorkspace(const LoadedMap& map);
+
+    SearchTree forward;         /**< Search from the origin (or the only search of a query). */
+    SearchTree backward;        /**< Search towards the destination. */
+    PotentialCache potentials;  /**< Distances to the destination from the customizable hierarchy, for the current query. */
+    SearchStats stats;          /**< Work done by the Dijkstra-based searches run with this workspace. */
+
+    /**
+     * @brief Selects the priority queue of the Dijkstra-based searches.
+     *
+     * @param kind Queue to use from the next search on. The default is QueueKind::Bucket, which falls back to
+     * the binary queue for searches the bucket queue cannot serve.
+     */
+    void setQueueKind(QueueKind kind) {
+        queueKind = kind;
+    }
+
+    /**
+     * @brief Priority queue used by the Dijkstra-based searches.
+     */
+    QueueKind getQueueKind() const {
+        return queueKind;
+    }
+
+    /**
+     * @brief Starts a new query: clears the banned edges and vertices.
+     *
+     * @note **Time Complexity:** O(1) amortized.
+     */
+    void reset();
+
+    /**
+     * @brief Bans an edge for the rest of the current query.
+     *
+     * @param edge CSR index of the edge that must not be used.
+     */
+    void banEdge(unsigned edge) {
+        if (bannedStamp[edge] != bannedEpoch) {
+            bannedStamp[edge] = bannedEpoch;
+            bannedEdges.push_back(edge);
+        }
+    }
+
+    /**
+     * @brief Checks whether any edge was banned in the current query.
+     */
+    bool hasBannedEdges() const {
+        return !bannedEdges.empty();
+    }
+
+    /**
+     * @brief CSR indices of the edges banned in the current query, in the order they were banned.
+     */
+    const std::vector<unsigned>& getBannedEdges() const {
+        return bannedEdges;
+    }
+
+    /**
+     * @brief Checks whether an edge was banned in the current query.
+     *
+     * @param edge CSR index of the edge to check.
+     */
+    bool isEdgeBanned(unsigned edge) const {
+        return bannedStamp[edge] == bannedEpoch;
+    }
+
+    /**
+     * @brief Replaces the set of vertices that the next search must avoid.
+     *
+     * @param map The loaded map.
+     * @param ignoreVertex IDs of the vertices to avoid.
+     * @note **Time Complexity:** O(K), K = number of vertices to avoid.
+     */
+    void setIgnoredVertices(const LoadedMap& map, const std::unordered_set<int>& ignoreVertex);
+
+    /**
+     * @brief Checks whether a vertex must be avoided by the current search.
+     *
+     * @param index Dense index of the vertex.
+     */
+    bool isVertexIgnored(int index) const {
+        return ignoredStamp[index] == ignoredEpoch;
+    }
+
+    /**
+     * @brief Marks the targets of a multi-target search.
+     *
+     * @param map The loaded map.
+     * @param targets IDs of the target vertices; unknown IDs are skipped.
+     * @return Number of distinct targets marked.
+     * @note **Time Complexity:** O(T), T = number of targets.
+     */
+    unsigned setTargets(const LoadedMap& map, const std::vector<int>& targets);
+
+    /**
+     * @brief Checks whether a vertex is a target of the current multi-target search.
+     *
+     * @param index Dense index of the vertex.
+     */
+    bool isTarget(int index) const {
+        return targetStamp[index] == targetEpoch;
+    }
+
+private:
+    void clearIgnoredVertices();
+
+    QueueKind queueKind = QueueKind::Bucket;
+    std::vector<unsigned> bannedStamp;
+    unsigned bannedEpoch = 1;
+    std::vector<unsigned> bannedEdges;
+    std::vector<unsigned> ignoredStamp;
+    unsigned ignoredEpoch = 1;
+    std::vector<unsigned> targetStamp;
+    unsigned targetEpoch = 1;
+};
+
+#endif // SEARCH_WORKSPACE_H
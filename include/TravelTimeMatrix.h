@@ -0,0 +1,81 @@
+#ifndef TRAVEL_TIME_MATRIX_H
+#define TRAVEL_TIME_MATRIX_H
+
+/**
+ * @file TravelTimeMatrix.h
+ * @brief One-to-many and many-to-many travel time matrices between lists of locations.
+ */
+
+#include <ostream>
+#include <vector>
+#include "CreatingMap.h"
+#include "SearchWorkspace.h"
+
+// Smallest matrix, in cells, for which MatrixMethod::Auto uses the bucket method
+// (matrixBenchmark: one search per source is faster for 1 x 100 on the bundled data, buckets from about 10 x 100)
+#define MATRIX_BUCKET_MIN_CELLS 1000
+
+/**
+ * @enum MatrixMethod
+ * @brief Algorithm used to fill a travel time matrix.
+ */
+enum class MatrixMethod {
+    Auto,       /**< Buckets when the matrix is large enough, else Dijkstra. */
+    Dijkstra,   /**< One Dijkstra search per source, stopped once every target is settled. */
+    Buckets     /**< Bucket-based many-to-many search on the contraction hierarchy, built on first use. */
+};
+
+/**
+ * @struct TravelTimeMatrix
+ * @brief Shortest travel times from every source to every target, stored densely in row-major order.
+ */
+struct TravelTimeMatrix {
+    std::vector<int> sources;       /**< Location IDs of the rows. */
+    std::vector<int> targets;       /**< Location IDs of the columns. */
+    std::vector<double> times;      /**< times[row * targets.size() + column]; INF if unreachable or the ID is unknown. */
+
+    /**
+     * @brief Travel time from a source to a target.
+     *
+     * @param row Position of the source in sources.
+     * @param column Position of the target in targets.
+     */
+    double at(size_t row, size_t column) const {
+        return times[row * targets.size() + column];
+    }
+};
+
+/**
+ * @brief Computes the shortest travel times from every source to every target.
+ *
+ * Like the route planners, only road segments open to driving are used, and the workspace bans are ignored.
+ * The sources are spread over a pool of worker threads sharing the map, each with its own workspace.
+ *
+ * @param map The loaded map.
+ * @param ws Search workspace of the calling thread; the other workers create their own.
+ * @param sources Location IDs of the origins.
+ * @param targets Location IDs of the destinations.
+ * @param driving True for driving times; false for walking times.
+ * @param method Algorithm to use.
+ * @param threads Number of worker threads (at least 1).
+ * @return The matrix; entries of unknown or unreachable locations are INF.
+ * @note **Time Complexity:** O(S (V + E) log V / T) with Dijkstra; O((S + T') U log U / T + B) with buckets,
+ *       U being the size of an upward search space, T' the number of targets and B the number of bucket entries scanned.
+ */
+TravelTimeMatrix computeTravelTimeMatrix(const LoadedMap& map, SearchWorkspace& ws, const std::vector<int>& sources,
+                                         const std::vector<int>& targets, bool driving, MatrixMethod method = MatrixMethod::Auto,
+                                         unsigned threads = 1);
+
+/**
+ * @brief Writes a travel time matrix in the batch output format.
+ *
+ * Lists the sources and targets, then one line of comma-separated times per source, with `none` for
+ * unreachable pairs and unknown locations.
+ *
+ * @param matrix Matrix to write.
+ * @param out Output stream.
+ * @note **Time Complexity:** O(S * T).
+ */
+void outputTravelTimeMatrix(const TravelTimeMatrix& matrix, std::ostream& out);
+
+#endif // TRAVEL_TIME_MATRIX_H
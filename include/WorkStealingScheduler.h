@@ -0,0 +1,91 @@
+#ifndef WORK_STEALING_SCHEDULER_H
+#define WORK_STEALING_SCHEDULER_H
+
+/**
+ * @file WorkStealingScheduler.h
+ * @brief Declaration of the work-stealing scheduler used to spread batch queries over worker threads.
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs independent, numbered tasks on a pool of worker threads with work stealing.
+ *
+ * Each worker owns a deque of task numbers, kept as a range [begin, end) since the tasks are numbered.
+ * Workers start with one contiguous share of the tasks each and take them from the front of their own range.
+ * A worker whose range is empty steals the back half of another worker's range, so expensive tasks
+ * bunched in one share do not leave the other cores idle at the end of the run.
+ * The worker threads are started once, with the scheduler, and wait for the next run in between, so a caller
+ * with many small runs does not pay for starting threads each time.
+ */
+class WorkStealingScheduler {
+public:
+    /**
+     * @brief Creates a scheduler for the given number of workers and starts their threads.
+     *
+     * @param workers Number of worker threads, including the calling thread (at least 1).
+     */
+    explicit WorkStealingScheduler(unsigned workers);
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~WorkStealingScheduler();
+
+    WorkStealingScheduler(const WorkStealingScheduler&) = delete;
+    WorkStealingScheduler& operator=(const WorkStealingScheduler&) = delete;
+
+    /**
+     * @brief Runs task(worker, i) for every i in [0, count) and waits for all of them.
+     *
+     * Worker 0 is the calling thread; the other workers are the scheduler's threads. A task is run exactly
+     * once, by one worker, and a worker runs its tasks one at a time. Runs must not overlap.
+     *
+     * @param count Number of tasks.
+     * @param task Function called with the worker number and the task number.
+     *
+     * @note **Time Complexity:** O(count + W^2) scheduling work for W workers, besides the tasks.
+     */
+    void run(std::size_t count, const std::function<void(unsigned, std::size_t)>& task);
+
+    unsigned getNumWorkers() const { return static_cast<unsigned>(deques.size()); }
+
+    /**
+     * @brief Returns the number of successful steals during the last run().
+     */
+    std::size_t getSteals() const;
+
+private:
+    /**
+     * @brief Task range of one worker, on its own cache line so that workers do not contend on each other's lock.
+     */
+    struct alignas(64) Deque {
+        std::mutex lock;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        std::size_t steals = 0;
+    };
+
+    void serve(unsigned worker);
+    void work(unsigned worker, const std::function<void(unsigned, std::size_t)>& task);
+    bool popFront(Deque& deque, std::size_t& taskIndex);
+    bool steal(unsigned thief);
+
+    std::vector<std::unique_ptr<Deque>> deques;
+    std::vector<std::thread> pool;
+    std::mutex runLock;
+    std::condition_variable started;    // a run started, or the scheduler is being destroyed
+    std::condition_variable finished;   // the last worker thread finished its part of the run
+    const std::function<void(unsigned, std::size_t)>* current = nullptr;
+    std::size_t runs = 0;               // runs started so far
+    unsigned busy = 0;                  // worker threads still working on the current run
+    bool stopping = false;
+};
+
+#endif // WORK_STEALING_SCHEDULER_H
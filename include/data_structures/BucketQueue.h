@@ -0,0 +1,123 @@
+// Monotone bucket queue (Dial's algorithm) over dense vertex indices, for integer keys.
+
+#ifndef DA_TP_CLASSES_BUCKETQUEUE
+#define DA_TP_CLASSES_BUCKETQUEUE
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/*
+ * Circular array of maxWeight + 1 buckets, each a doubly linked list of vertex indices.
+ * Valid for Dijkstra over non-negative integer weights no larger than maxWeight: every key
+ * inserted lies between the last extracted key and that key plus maxWeight, so at most
+ * maxWeight + 1 distinct keys are queued at once and each one maps to its own bucket.
+ * Insert and decrease-key are O(1); extractMin skips at most maxWeight empty buckets.
+ *
+ * Bucket heads are only valid when their stamp matches the current epoch, so clearing
+ * the queue after an early stop does not sweep the buckets.
+ */
+class BucketQueue {
+public:
+    typedef unsigned long long Key;
+
+    /*
+     * Sizes the queue for the given number of vertices and largest edge weight (no-op if already sized).
+     */
+    void resize(std::size_t numVertices, unsigned maxWeight);
+
+    std::size_t getNumVertices() const { return bucketOf.size(); }
+    unsigned getMaxWeight() const { return static_cast<unsigned>(head.size()) - 1; }
+    bool empty() const { return count == 0; }
+
+    /*
+     * Removes all items in O(1).
+     */
+    void clear();
+
+    void insert(unsigned index, Key key);
+    void decreaseKey(unsigned index, Key key);
+    unsigned extractMin();
+
+private:
+    static constexpr unsigned NONE = std::numeric_limits<unsigned>::max();
+
+    unsigned first(unsigned bucket) const { return headStamp[bucket] == epoch ? head[bucket] : NONE; }
+    void link(unsigned index, unsigned bucket);
+    void unlink(unsigned index);
+
+    std::vector<unsigned> head;         // first vertex of each bucket
+    std::vector<unsigned> headStamp;    // epoch in which each head was last written
+    std::vector<unsigned> next;         // next vertex in the same bucket
+    std::vector<unsigned> prev;         // previous vertex in the same bucket, NONE for the first one
+    std::vector<unsigned> bucketOf;     // bucket of each queued vertex
+    unsigned epoch = 1;
+    std::size_t count = 0;
+    Key current = 0;                    // last extracted key: no smaller key can be queued any more
+    bool started = false;               // false until the first insert after a clear
+};
+
+inline void BucketQueue::resize(std::size_t numVertices, unsigned maxWeight) {
+    if (bucketOf.size() == numVertices && head.size() == std::size_t(maxWeight) + 1) return;
+    head.assign(std::size_t(maxWeight) + 1, NONE);
+    headStamp.assign(head.size(), 0);
+    next.assign(numVertices, NONE);
+    prev.assign(numVertices, NONE);
+    bucketOf.assign(numVertices, 0);
+    epoch = 1;
+    count = 0;
+    started = false;
+}
+
+inline void BucketQueue::clear() {
+    count = 0;
+    started = false;
+    if (++epoch == 0) {
+        for (auto &s : headStamp) s = 0;
+        epoch = 1;
+    }
+}
+
+inline void BucketQueue::link(unsigned index, unsigned bucket) {
+    unsigned old = first(bucket);
+    next[index] = old;
+    prev[index] = NONE;
+    if (old != NONE) prev[old] = index;
+    head[bucket] = index;
+    headStamp[bucket] = epoch;
+    bucketOf[index] = bucket;
+}
+
+inline void BucketQueue::unlink(unsigned index) {
+    if (prev[index] != NONE) next[prev[index]] = next[index];
+    else head[bucketOf[index]] = next[index];
+    if (next[index] != NONE) prev[next[index]] = prev[index];
+}
+
+inline void BucketQueue::insert(unsigned index, Key key) {
+    if (!started) {
+        current = key;
+        started = true;
+    }
+    count++;
+    link(index, static_cast<unsigned>(key % head.size()));
+}
+
+inline void BucketQueue::decreaseKey(unsigned index, Key key) {
+    unlink(index);
+    link(index, static_cast<unsigned>(key % head.size()));
+}
+
+inline unsigned BucketQueue::extractMin() {
+    unsigned bucket = static_cast<unsigned>(current % head.size());
+    while (first(bucket) == NONE) {
+        current++;
+        if (++bucket == head.size()) bucket = 0;
+    }
+    unsigned index = head[bucket];
+    unlink(index);
+    count--;
+    return index;
+}
+
+#endif
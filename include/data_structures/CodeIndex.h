@@ -0,0 +1,106 @@
+// Open-addressing hash index from location codes to dense vertex indices, used when loading the data files.
+
+#ifndef DA_TP_CLASSES_CODEINDEX
+#define DA_TP_CLASSES_CODEINDEX
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Linear-probing table at most half full, whose slots hold the code itself next to its value:
+ * a lookup reads one slot (usually one cache line) instead of following a chain of nodes and then
+ * the key string, which dominates loading when the distance file references millions of locations.
+ * Codes longer than INLINE characters, rare in practice, go to a std::unordered_map instead.
+ *
+ * Lookups take string views, so codes can be looked up straight from a mapped file. The index is
+ * not modified by find(), so several threads may look codes up at the same time.
+ */
+class CodeIndex {
+public:
+    static constexpr unsigned NONE = std::numeric_limits<unsigned>::max();
+
+    /*
+     * Empties the index and sizes it for the given number of codes.
+     */
+    void reserve(std::size_t numCodes);
+
+    /*
+     * Maps code to value, replacing the value of a code already present.
+     * The index must have been reserved for at least as many codes as are inserted.
+     */
+    void insert(std::string_view code, unsigned value);
+
+    /*
+     * Returns the value of code, or NONE if the code is not in the index.
+     */
+    unsigned find(std::string_view code) const;
+
+    std::size_t size() const { return count; }
+
+private:
+    static constexpr std::size_t INLINE = 27;
+
+    struct Slot {
+        unsigned value = NONE;      // NONE for an empty slot
+        unsigned char length = 0;
+        char code[INLINE];
+    };
+
+    std::size_t slotOf(std::string_view code) const { return std::hash<std::string_view>()(code) & mask; }
+    static bool matches(const Slot &slot, std::string_view code) {
+        return slot.length == code.size() && std::memcmp(slot.code, code.data(), code.size()) == 0;
+    }
+
+    std::vector<Slot> slots;
+    std::size_t mask = 0;
+    std::size_t count = 0;
+    std::unordered_map<std::string, unsigned> longCodes;
+};
+
+inline void CodeIndex::reserve(std::size_t numCodes) {
+    std::size_t capacity = 16;
+    while (capacity < 2 * numCodes) capacity <<= 1;
+    slots.assign(capacity, Slot());
+    mask = capacity - 1;
+    count = 0;
+    longCodes.clear();
+}
+
+inline void CodeIndex::insert(std::string_view code, unsigned value) {
+    if (code.size() > INLINE) {
+        if (longCodes.insert_or_assign(std::string(code), value).second) count++;
+        return;
+    }
+    std::size_t i = slotOf(code);
+    while (slots[i].value != NONE) {
+        if (matches(slots[i], code)) {
+            slots[i].value = value;
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    slots[i].value = value;
+    slots[i].length = static_cast<unsigned char>(code.size());
+    std::memcpy(slots[i].code, code.data(), code.size());
+    count++;
+}
+
+inline unsigned CodeIndex::find(std::string_view code) const {
+    if (code.size() > INLINE) {
+        auto it = longCodes.find(std::string(code));
+        return it == longCodes.end() ? NONE : it->second;
+    }
+    if (slots.empty()) return NONE;
+    for (std::size_t i = slotOf(code); slots[i].value != NONE; i = (i + 1) & mask) {
+        if (matches(slots[i], code)) return slots[i].value;
+    }
+    return NONE;
+}
+
+#endif
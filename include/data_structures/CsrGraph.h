@@ -0,0 +1,267 @@
+// Frozen compressed sparse row (CSR) snapshot of a Graph, used by the routing algorithms.
+
+#ifndef DA_TP_CLASSES_CSRGRAPH
+#define DA_TP_CLASSES_CSRGRAPH
+
+#include <vector>
+#include <limits>
+#include <unordered_map>
+#include "Graph.h"
+#include "FrozenArray.h"
+
+#define NO_EDGE std::numeric_limits<unsigned>::max()
+
+/************************* IndexRange  **************************/
+
+/*
+ * Contiguous range of edge indices that can be iterated with a range-based for loop
+ * without allocating, e.g. for (unsigned e : csr.edges(v)).
+ */
+class IndexRange {
+public:
+    class iterator {
+    public:
+        explicit iterator(unsigned i): i(i) {}
+        unsigned operator*() const { return i; }
+        iterator &operator++() { ++i; return *this; }
+        bool operator!=(const iterator &other) const { return i != other.i; }
+    private:
+        unsigned i;
+    };
+
+    IndexRange(unsigned first, unsigned last): first(first), last(last) {}
+    iterator begin() const { return iterator(first); }
+    iterator end() const { return iterator(last); }
+    unsigned size() const { return last - first; }
+private:
+    unsigned first, last;
+};
+
+/************************* CsrGraph  **************************/
+
+/*
+ * Read-only copy of a Graph<T> laid out as structure-of-arrays.
+ * The outgoing edges of vertex v are the edge indices in [edgesBegin(v), edgesEnd(v)),
+ * stored in the same order as in Vertex::getAdj(). The incoming edges of v are listed in
+ * a second offset array and refer back to the outgoing edge indices.
+ * Vertices are identified by their dense index (Vertex::getIndex).
+ * The edge arrays are either built from a Graph or attached to arrays stored elsewhere,
+ * such as a memory-mapped map file; the vertex contents are always held in memory.
+ */
+template <class T>
+class CsrGraph {
+public:
+    CsrGraph() = default;
+    explicit CsrGraph(const Graph<T> &g);
+
+    /*
+     * Rebuilds the snapshot from the given graph.
+     */
+    void build(const Graph<T> &g);
+
+    /*
+     * Raw edge arrays of the snapshot, laid out as described for the members below.
+     */
+    struct Arrays {
+        const unsigned *offsets, *sources, *targets;
+        const double *driving, *walking;
+        const unsigned *reverse, *inOffsets, *inEdges;
+    };
+
+    Arrays arrays() const;
+
+    /*
+     * Replaces the snapshot with the given vertex contents and edge arrays, which are viewed, not copied,
+     * and must outlive the snapshot (or the next build). The offset arrays hold info.size() + 1 entries.
+     */
+    void attach(std::vector<T> vertices, const Arrays &a);
+
+    unsigned getNumVertex() const;
+    unsigned getNumEdges() const;
+    const T &getInfo(unsigned v) const;
+
+    unsigned edgesBegin(unsigned v) const;
+    unsigned edgesEnd(unsigned v) const;
+    IndexRange edges(unsigned v) const;
+    unsigned getSource(unsigned e) const;
+    unsigned getTarget(unsigned e) const;
+    double getDriving(unsigned e) const;
+    double getWalking(unsigned e) const;
+    unsigned getReverse(unsigned e) const;
+
+    unsigned incomingBegin(unsigned v) const;
+    unsigned incomingEnd(unsigned v) const;
+    IndexRange incoming(unsigned v) const;
+    unsigned getIncoming(unsigned i) const;
+
+protected:
+    std::vector<T> info;                // vertex contents, by dense index
+
+    FrozenArray<unsigned> offsets;      // outgoing edges of v: [offsets[v], offsets[v + 1])
+    FrozenArray<unsigned> sources;      // edge origin
+    FrozenArray<unsigned> targets;      // edge destination
+    FrozenArray<double> driving;        // edge driving time
+    FrozenArray<double> walking;        // edge walking time
+    FrozenArray<unsigned> reverse;      // reverse edge index, or NO_EDGE
+
+    FrozenArray<unsigned> inOffsets;    // incoming edges of v: [inOffsets[v], inOffsets[v + 1])
+    FrozenArray<unsigned> inEdges;      // outgoing edge indices, grouped by destination
+};
+
+/************************* CsrGraph  **************************/
+
+template <class T>
+CsrGraph<T>::CsrGraph(const Graph<T> &g) {
+    build(g);
+}
+
+template <class T>
+void CsrGraph<T>::build(const Graph<T> &g) {
+    unsigned n = g.getNumVertex();
+    info.clear();
+    info.reserve(n);
+    offsets.assign(n + 1, 0);
+    for (unsigned v = 0; v < n; v++) {
+        const Vertex<T> *vertex = g.getVertex(v);
+        info.push_back(vertex->getInfo());
+        offsets[v + 1] = offsets[v] + vertex->getAdj().size();
+    }
+
+    unsigned m = offsets[n];
+    sources.resize(m);
+    targets.resize(m);
+    driving.resize(m);
+    walking.resize(m);
+    reverse.assign(m, NO_EDGE);
+    inOffsets.assign(n + 1, 0);
+
+    // Position of each edge, needed to resolve the reverse pointers
+    std::unordered_map<const Edge<T> *, unsigned> position;
+    position.reserve(m);
+    for (unsigned v = 0; v < n; v++) {
+        unsigned e = offsets[v];
+        for (auto edge : g.getVertex(v)->getAdj()) {
+            sources[e] = v;
+            targets[e] = edge->getDest()->getIndex();
+            driving[e] = edge->getDriving();
+            walking[e] = edge->getWalking();
+            position[edge] = e;
+            inOffsets[targets[e] + 1]++;
+            e++;
+        }
+    }
+    for (unsigned v = 0; v < n; v++) {
+        unsigned e = offsets[v];
+        for (auto edge : g.getVertex(v)->getAdj()) {
+            auto it = position.find(edge->getReverse());
+            if (it != position.end())
+                reverse[e] = it->second;
+            e++;
+        }
+    }
+
+    for (unsigned v = 0; v < n; v++)
+        inOffsets[v + 1] += inOffsets[v];
+    inEdges.resize(m);
+    std::vector<unsigned> next(inOffsets.begin(), inOffsets.end() - 1);
+    for (unsigned e = 0; e < m; e++)
+        inEdges[next[targets[e]]++] = e;
+}
+
+template <class T>
+typename CsrGraph<T>::Arrays CsrGraph<T>::arrays() const {
+    return Arrays{offsets.data(), sources.data(), targets.data(), driving.data(), walking.data(),
+                  reverse.data(), inOffsets.data(), inEdges.data()};
+}
+
+template <class T>
+void CsrGraph<T>::attach(std::vector<T> vertices, const Arrays &a) {
+    info = std::move(vertices);
+    unsigned n = info.size();
+    unsigned m = a.offsets[n];
+    offsets.attach(a.offsets, n + 1);
+    sources.attach(a.sources, m);
+    targets.attach(a.targets, m);
+    driving.attach(a.driving, m);
+    walking.attach(a.walking, m);
+    reverse.attach(a.reverse, m);
+    inOffsets.attach(a.inOffsets, n + 1);
+    inEdges.attach(a.inEdges, m);
+}
+
+template <class T>
+unsigned CsrGraph<T>::getNumVertex() const {
+    return info.size();
+}
+
+template <class T>
+unsigned CsrGraph<T>::getNumEdges() const {
+    return targets.size();
+}
+
+template <class T>
+const T &CsrGraph<T>::getInfo(unsigned v) const {
+    return info[v];
+}
+
+template <class T>
+unsigned CsrGraph<T>::edgesBegin(unsigned v) const {
+    return offsets[v];
+}
+
+template <class T>
+unsigned CsrGraph<T>::edgesEnd(unsigned v) const {
+    return offsets[v + 1];
+}
+
+template <class T>
+IndexRange CsrGraph<T>::edges(unsigned v) const {
+    return IndexRange(offsets[v], offsets[v + 1]);
+}
+
+template <class T>
+unsigned CsrGraph<T>::getSource(unsigned e) const {
+    return sources[e];
+}
+
+template <class T>
+unsigned CsrGraph<T>::getTarget(unsigned e) const {
+    return targets[e];
+}
+
+template <class T>
+double CsrGraph<T>::getDriving(unsigned e) const {
+    return driving[e];
+}
+
+template <class T>
+double CsrGraph<T>::getWalking(unsigned e) const {
+    return walking[e];
+}
+
+template <class T>
+unsigned CsrGraph<T>::getReverse(unsigned e) const {
+    return reverse[e];
+}
+
+template <class T>
+unsigned CsrGraph<T>::incomingBegin(unsigned v) const {
+    return inOffsets[v];
+}
+
+template <class T>
+unsigned CsrGraph<T>::incomingEnd(unsigned v) const {
+    return inOffsets[v + 1];
+}
+
+template <class T>
+IndexRange CsrGraph<T>::incoming(unsigned v) const {
+    return IndexRange(inOffsets[v], inOffsets[v + 1]);
+}
+
+template <class T>
+unsigned CsrGraph<T>::getIncoming(unsigned i) const {
+    return inEdges[i];
+}
+
+#endif /* DA_TP_CLASSES_CSRGRAPH */
@@ -0,0 +1,158 @@
+// Implicit d-ary min-heap of (key, vertex index) pairs, with decrease-key, used by the routing searches.
+
+#ifndef DA_TP_CLASSES_DARYHEAP
+#define DA_TP_CLASSES_DARYHEAP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+/************************* AlignedAllocator  **************************/
+
+/*
+ * Allocator returning storage aligned to Alignment bytes (a power of two, at least alignof(T)),
+ * so that a heap can place each group of siblings on its own cache line.
+ */
+template <class T, std::size_t Alignment>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    template <class U>
+    struct rebind {
+        typedef AlignedAllocator<U, Alignment> other;
+    };
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment> &) {}
+
+    T *allocate(std::size_t n) {
+        std::size_t bytes = (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        if (void *p = std::aligned_alloc(Alignment, bytes ? bytes : Alignment)) return static_cast<T *>(p);
+        throw std::bad_alloc();
+    }
+
+    void deallocate(T *p, std::size_t) {
+        std::free(p);
+    }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment> &) const { return true; }
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment> &) const { return false; }
+};
+
+/************************* DaryHeap  **************************/
+
+/*
+ * Min-heap with Arity children per node, storing (key, index) pairs contiguously.
+ * Items are dense vertex indices in [0, numVertices); the position of each queued item is
+ * kept in a side array so its key can be decreased.
+ *
+ * The array starts Arity - 1 slots before the root and is aligned to 64 bytes, so the children
+ * of a node always start on a multiple of Arity slots: with Arity = 4 they share one cache line.
+ * Ties between equal keys are not broken in any particular order.
+ */
+template <unsigned Arity>
+class DaryHeap {
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+public:
+    struct Entry {
+        double key;
+        unsigned index;
+    };
+
+    /*
+     * Sizes the position array for the given number of vertices (no-op if already sized).
+     */
+    void resize(std::size_t numVertices);
+
+    std::size_t getNumVertices() const { return position.size(); }
+    bool empty() const { return entries.size() == OFFSET; }
+    std::size_t size() const { return entries.size() - OFFSET; }
+
+    /*
+     * Removes all items but keeps the allocated capacity for reuse.
+     */
+    void clear() { entries.resize(OFFSET); }
+
+    void insert(unsigned index, double key);
+    void decreaseKey(unsigned index, double key);
+    unsigned extractMin();
+    double topKey() const { return entries[OFFSET].key; }
+    unsigned top() const { return entries[OFFSET].index; }
+
+private:
+    static const unsigned OFFSET = Arity - 1;
+
+    void siftUp(unsigned i, Entry x);
+    void siftDown(unsigned i, Entry x);
+
+    std::vector<Entry, AlignedAllocator<Entry, 64>> entries = std::vector<Entry, AlignedAllocator<Entry, 64>>(OFFSET);
+    std::vector<unsigned> position;     // slot of each queued index in entries
+};
+
+template <unsigned Arity>
+void DaryHeap<Arity>::resize(std::size_t numVertices) {
+    if (position.size() != numVertices) position.assign(numVertices, 0);
+}
+
+template <unsigned Arity>
+void DaryHeap<Arity>::insert(unsigned index, double key) {
+    entries.push_back(Entry{key, index});
+    siftUp(entries.size() - 1, entries.back());
+}
+
+template <unsigned Arity>
+void DaryHeap<Arity>::decreaseKey(unsigned index, double key) {
+    siftUp(position[index], Entry{key, index});
+}
+
+template <unsigned Arity>
+unsigned DaryHeap<Arity>::extractMin() {
+    unsigned min = entries[OFFSET].index;
+    Entry last = entries.back();
+    entries.pop_back();
+    if (!empty()) siftDown(OFFSET, last);
+    return min;
+}
+
+// Slots are heap positions shifted by OFFSET: the parent of slot i is (i - OFFSET - 1) / Arity + OFFSET,
+// and its children start at slot Arity * (i - OFFSET + 1), always a multiple of Arity.
+template <unsigned Arity>
+void DaryHeap<Arity>::siftUp(unsigned i, Entry x) {
+    while (i > OFFSET) {
+        unsigned parent = (i - OFFSET - 1) / Arity + OFFSET;
+        if (!(x.key < entries[parent].key)) break;
+        entries[i] = entries[parent];
+        position[entries[i].index] = i;
+        i = parent;
+    }
+    entries[i] = x;
+    position[x.index] = i;
+}
+
+template <unsigned Arity>
+void DaryHeap<Arity>::siftDown(unsigned i, Entry x) {
+    unsigned n = entries.size();
+    while (true) {
+        unsigned first = Arity * (i - OFFSET + 1);
+        if (first >= n) break;
+        unsigned last = first + Arity < n ? first + Arity : n;
+        unsigned best = first;
+        for (unsigned k = first + 1; k < last; k++) {
+            if (entries[k].key < entries[best].key) best = k;
+        }
+        if (!(entries[best].key < x.key)) break;
+        entries[i] = entries[best];
+        position[entries[i].index] = i;
+        i = best;
+    }
+    entries[i] = x;
+    position[x.index] = i;
+}
+
+#endif
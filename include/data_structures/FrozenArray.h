@@ -0,0 +1,61 @@
+// Read-only array that either owns its elements or views elements stored elsewhere, such as a memory-mapped file.
+
+#ifndef DA_TP_CLASSES_FROZENARRAY
+#define DA_TP_CLASSES_FROZENARRAY
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*
+ * Backing store of the frozen routing structures. While it is being built the array owns its elements
+ * in a std::vector, which assign() and resize() size and the non-const operator[] fills. attach() instead
+ * points it at elements owned by someone else (typically pages of a mapped map file, shared by every process
+ * mapping the same file), which must outlive the array. Reads always go through one pointer, so both kinds
+ * cost the same to access.
+ */
+template <class T>
+class FrozenArray {
+public:
+    FrozenArray() = default;
+    FrozenArray(const FrozenArray &other): owned(other.owned), view(other.view), count(other.count) { track(); }
+    FrozenArray &operator=(const FrozenArray &other) {
+        owned = other.owned;
+        view = other.view;
+        count = other.count;
+        track();
+        return *this;
+    }
+
+    void assign(std::size_t n, const T &value) { owned.assign(n, value); view = owned.data(); count = n; }
+    void resize(std::size_t n) { owned.resize(n); view = owned.data(); count = n; }
+    void assign(std::vector<T> elements) { owned = std::move(elements); view = owned.data(); count = owned.size(); }
+
+    /*
+     * Views n elements at data instead of owning a copy, releasing the owned elements.
+     */
+    void attach(const T *data, std::size_t n) {
+        std::vector<T>().swap(owned);
+        view = data;
+        count = n;
+    }
+
+    // Only while the array owns its elements
+    T &operator[](std::size_t i) { return owned[i]; }
+
+    const T &operator[](std::size_t i) const { return view[i]; }
+    const T *data() const { return view; }
+    const T *begin() const { return view; }
+    const T *end() const { return view + count; }
+    std::size_t size() const { return count; }
+
+private:
+    // A copy of an owning array must point at its own elements
+    void track() { if (!owned.empty() || view == nullptr) view = owned.data(); }
+
+    std::vector<T> owned;
+    const T *view = nullptr;
+    std::size_t count = 0;
+};
+
+#endif /* DA_TP_CLASSES_FROZENARRAY */
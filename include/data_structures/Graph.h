@@ -9,6 +9,7 @@
 #include <queue>
 #include <limits>
 #include <algorithm>
+#include <unordered_map>
 #include "MutablePriorityQueue.h" // not needed for now
 
 template <class T>
@@ -24,15 +25,16 @@ public:
     Vertex(T in);
     bool operator<(Vertex<T> & vertex) const; // // required by MutablePriorityQueue
 
-    T getInfo() const;
-    std::vector<Edge<T> *> getAdj() const;
+    const T &getInfo() const;
+    const std::vector<Edge<T> *> &getAdj() const;
     bool isVisited() const;
     bool isProcessing() const;
     unsigned int getIndegree() const;
     double getDist() const;
     double getWalkDist() const;
     Edge<T> *getPath() const;
-    std::vector<Edge<T> *> getIncoming() const;
+    const std::vector<Edge<T> *> &getIncoming() const;
+    int getIndex() const;
 
     void setInfo(T info);
     void setVisited(bool visited);
@@ -47,7 +49,9 @@ public:
     void setDist(double dist);
     void setWalkDist(double walkdist);
     void setPath(Edge<T> *path);
+    void setIndex(int index);
     Edge<T> * addEdge(Vertex<T> *dest, double w,double walk);
+    void reserveEdges(std::size_t outgoing, std::size_t incoming);
     bool removeEdge(T in);
     void removeOutgoingEdges();
 
@@ -67,6 +71,8 @@ protected:
 
     std::vector<Edge<T> *> incoming; // incoming edges
 
+    int index = -1; // position in the graph's vertex set, used to index per-query search state
+
     int queueIndex = 0; 		// required by MutablePriorityQueue and UFDS
 
     void deleteEdge(Edge<T> *edge);
@@ -116,7 +122,13 @@ protected:
 template <class T>
 class Graph {
 public:
+    Graph() = default;
     ~Graph();
+    /*
+     * The graph owns its vertices and edges, so it cannot be copied.
+     */
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
     /*
     * Auxiliary function to find a vertex with a given the content.
     */
@@ -136,17 +148,23 @@ public:
     bool addEdge(const T &sourc, const T &dest, double w,double walk);
     bool removeEdge(const T &source, const T &dest);
     bool addBidirectionalEdge(const T &sourc, const T &dest, double w,double walk);
+    /*
+     * Same as above, for vertices that were already looked up, so no hashing is needed.
+     */
+    void addBidirectionalEdge(Vertex<T> *v1, Vertex<T> *v2, double w,double walk);
 
     int getNumVertex() const;
 
-    std::vector<Vertex<T> *> getVertexSet() const;
+    const std::vector<Vertex<T> *> &getVertexSet() const;
+    /*
+     * Returns the vertex at the given dense index (see Vertex::getIndex).
+     */
+    Vertex<T> *getVertex(int index) const;
 
 
 protected:
     std::vector<Vertex<T> *> vertexSet;    // vertex set
-
-    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
-    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
+    std::unordered_map<T, int> vertexIndex; // vertex content -> position in vertexSet (requires std::hash<T>)
 
     /*
      * Finds the index of the vertex with a given content.
@@ -158,9 +176,6 @@ protected:
 
 };
 
-void deleteMatrix(int **m, int n);
-void deleteMatrix(double **m, int n);
-
 
 /************************* Vertex  **************************/
 
@@ -202,6 +217,16 @@ bool Vertex<T>::removeEdge(T in) {
     return removedEdge;
 }
 
+/*
+ * Makes room for the given number of additional outgoing and incoming edges,
+ * so that adding them does not regrow the adjacency lists.
+ */
+template <class T>
+void Vertex<T>::reserveEdges(std::size_t outgoing, std::size_t incoming) {
+    adj.reserve(adj.size() + outgoing);
+    this->incoming.reserve(this->incoming.size() + incoming);
+}
+
 /*
  * Auxiliary function to remove an outgoing edge of a vertex.
  */
@@ -221,7 +246,7 @@ bool Vertex<T>::operator<(Vertex<T> & vertex) const {
 }
 
 template <class T>
-T Vertex<T>::getInfo() const {
+const T &Vertex<T>::getInfo() const {
     return this->info;
 }
 
@@ -246,7 +271,7 @@ void Vertex<T>::setNum(int value) {
 }
 
 template <class T>
-std::vector<Edge<T>*> Vertex<T>::getAdj() const {
+const std::vector<Edge<T>*> &Vertex<T>::getAdj() const {
     return this->adj;
 }
 
@@ -282,10 +307,15 @@ Edge<T> *Vertex<T>::getPath() const {
 }
 
 template <class T>
-std::vector<Edge<T> *> Vertex<T>::getIncoming() const {
+const std::vector<Edge<T> *> &Vertex<T>::getIncoming() const {
     return this->incoming;
 }
 
+template <class T>
+int Vertex<T>::getIndex() const {
+    return this->index;
+}
+
 template <class T>
 void Vertex<T>::setInfo(T in) {
     this->info = in;
@@ -321,6 +351,11 @@ void Vertex<T>::setPath(Edge<T> *path) {
     this->path = path;
 }
 
+template <class T>
+void Vertex<T>::setIndex(int index) {
+    this->index = index;
+}
+
 template <class T>
 void Vertex<T>::deleteEdge(Edge<T> *edge) {
     Vertex<T> *dest = edge->getDest();
@@ -411,19 +446,23 @@ int Graph<T>::getNumVertex() const {
 }
 
 template <class T>
-std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
+const std::vector<Vertex<T> *> &Graph<T>::getVertexSet() const {
     return vertexSet;
 }
 
+template <class T>
+Vertex<T> * Graph<T>::getVertex(int index) const {
+    return vertexSet[index];
+}
+
 /*
  * Auxiliary function to find a vertex with a given content.
+ * Uses the hashed index, so it takes O(1) on average.
  */
 template <class T>
 Vertex<T> * Graph<T>::findVertex(const T &in) const {
-    for (auto v : vertexSet)
-        if (v->getInfo() == in)
-            return v;
-    return nullptr;
+    int idx = findVertexIdx(in);
+    return idx == -1 ? nullptr : vertexSet[idx];
 }
 
 /*
@@ -431,10 +470,8 @@ Vertex<T> * Graph<T>::findVertex(const T &in) const {
  */
 template <class T>
 int Graph<T>::findVertexIdx(const T &in) const {
-    for (unsigned i = 0; i < vertexSet.size(); i++)
-        if (vertexSet[i]->getInfo() == in)
-            return i;
-    return -1;
+    auto it = vertexIndex.find(in);
+    return it == vertexIndex.end() ? -1 : it->second;
 }
 /*
  *  Adds a vertex with a given content or info (in) to a graph (this).
@@ -442,9 +479,11 @@ int Graph<T>::findVertexIdx(const T &in) const {
  */
 template <class T>
 bool Graph<T>::addVertex(const T &in) {
-    if (findVertex(in) != nullptr)
+    if (!vertexIndex.emplace(in, vertexSet.size()).second)
         return false;
-    vertexSet.push_back(new Vertex<T>(in));
+    auto v = new Vertex<T>(in);
+    v->setIndex(vertexSet.size());
+    vertexSet.push_back(v);
     return true;
 }
 
@@ -462,8 +501,14 @@ bool Graph<T>::removeVertex(const T &in) {
             for (auto u : vertexSet) {
                 u->removeEdge(v->getInfo());
             }
-            vertexSet.erase(it);
+            it = vertexSet.erase(it);
+            vertexIndex.erase(v->getInfo());
             delete v;
+            // keep the indices of the remaining vertices dense
+            for (; it != vertexSet.end(); it++) {
+                (*it)->setIndex((*it)->getIndex() - 1);
+                vertexIndex[(*it)->getInfo()] = (*it)->getIndex();
+            }
             return true;
         }
     }
@@ -505,35 +550,25 @@ bool Graph<T>::addBidirectionalEdge(const T &sourc, const T &dest, double w,doub
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return false;
+    addBidirectionalEdge(v1, v2, w, walk);
+    return true;
+}
+
+template <class T>
+void Graph<T>::addBidirectionalEdge(Vertex<T> *v1, Vertex<T> *v2, double w,double walk) {
     auto e1 = v1->addEdge(v2, w,walk);
     auto e2 = v2->addEdge(v1, w,walk);
     e1->setReverse(e2);
     e2->setReverse(e1);
-    return true;
-}
-
-inline void deleteMatrix(int **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
-    }
-}
-
-inline void deleteMatrix(double **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
-    }
 }
 
 template <class T>
 Graph<T>::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+    for (auto v : vertexSet) {
+        for (auto e : v->getAdj())
+            delete e;
+        delete v;
+    }
 }
 
 #endif /* DA_TP_CLASSES_GRAPH */
\ No newline at end of file
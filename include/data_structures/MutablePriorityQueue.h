@@ -25,8 +25,10 @@ public:
     MutablePriorityQueue();
     void insert(T * x);
     T * extractMin();
+    T * top();
     void decreaseKey(T * x);
     bool empty();
+    void clear();
 };
 
 // Index calculations
@@ -45,6 +47,12 @@ bool MutablePriorityQueue<T>::empty() {
     return H.size() == 1;
 }
 
+// Removes all elements but keeps the allocated capacity for reuse
+template <class T>
+void MutablePriorityQueue<T>::clear() {
+    H.resize(1);
+}
+
 template <class T>
 T* MutablePriorityQueue<T>::extractMin() {
     auto x = H[1];
@@ -55,6 +63,12 @@ T* MutablePriorityQueue<T>::extractMin() {
     return x;
 }
 
+// Returns the minimum element without removing it
+template <class T>
+T* MutablePriorityQueue<T>::top() {
+    return H[1];
+}
+
 template <class T>
 void MutablePriorityQueue<T>::insert(T *x) {
     H.push_back(x);
@@ -0,0 +1,113 @@
+// Pairing min-heap over dense vertex indices, with decrease-key, used by the routing searches.
+
+#ifndef DA_TP_CLASSES_PAIRINGHEAP
+#define DA_TP_CLASSES_PAIRINGHEAP
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/*
+ * Pairing heap whose nodes are the vertex indices themselves: the key and the child, sibling
+ * and previous links of each vertex live in arrays indexed by vertex, so the heap never allocates
+ * once sized. Insert and decrease-key are O(1); extractMin is O(log n) amortized, using the
+ * standard two-pass pairing of the root's children.
+ */
+class PairingHeap {
+public:
+    /*
+     * Sizes the node arrays for the given number of vertices (no-op if already sized).
+     */
+    void resize(std::size_t numVertices);
+
+    std::size_t getNumVertices() const { return nodes.size(); }
+    bool empty() const { return root == NONE; }
+
+    /*
+     * Removes all items. Links are rewritten on insert, so nothing needs to be swept.
+     */
+    void clear() { root = NONE; }
+
+    void insert(unsigned index, double key);
+    void decreaseKey(unsigned index, double key);
+    unsigned extractMin();
+    double topKey() const { return nodes[root].key; }
+    unsigned top() const { return root; }
+
+private:
+    static constexpr unsigned NONE = std::numeric_limits<unsigned>::max();
+
+    struct Node {
+        double key;
+        unsigned child;     // first child
+        unsigned sibling;   // next sibling
+        unsigned prev;      // previous sibling, or the parent for a first child
+    };
+
+    unsigned meld(unsigned a, unsigned b);
+
+    std::vector<Node> nodes;
+    std::vector<unsigned> pairs;    // scratch list of the root's children, kept to reuse its capacity
+    unsigned root = NONE;
+};
+
+inline void PairingHeap::resize(std::size_t numVertices) {
+    if (nodes.size() != numVertices) nodes.assign(numVertices, Node{0, NONE, NONE, NONE});
+    root = NONE;
+}
+
+// Links two roots, making the one with the larger key the first child of the other.
+inline unsigned PairingHeap::meld(unsigned a, unsigned b) {
+    if (nodes[b].key < nodes[a].key) {
+        unsigned t = a;
+        a = b;
+        b = t;
+    }
+    Node &child = nodes[b];
+    child.sibling = nodes[a].child;
+    child.prev = a;
+    if (nodes[a].child != NONE) nodes[nodes[a].child].prev = b;
+    nodes[a].child = b;
+    return a;
+}
+
+inline void PairingHeap::insert(unsigned index, double key) {
+    Node &n = nodes[index];
+    n.key = key;
+    n.child = n.sibling = n.prev = NONE;
+    root = root == NONE ? index : meld(root, index);
+}
+
+inline void PairingHeap::decreaseKey(unsigned index, double key) {
+    Node &n = nodes[index];
+    n.key = key;
+    if (index == root) return;
+    // Cut the subtree out of its parent's child list, then meld it back with the root
+    if (nodes[n.prev].child == index) nodes[n.prev].child = n.sibling;
+    else nodes[n.prev].sibling = n.sibling;
+    if (n.sibling != NONE) nodes[n.sibling].prev = n.prev;
+    n.sibling = n.prev = NONE;
+    root = meld(root, index);
+}
+
+inline unsigned PairingHeap::extractMin() {
+    unsigned min = root;
+    pairs.clear();
+    for (unsigned c = nodes[min].child; c != NONE; c = nodes[c].sibling) pairs.push_back(c);
+    if (pairs.empty()) {
+        root = NONE;
+        return min;
+    }
+    for (unsigned c : pairs) nodes[c].sibling = nodes[c].prev = NONE;
+
+    // First pass: meld the children in pairs, left to right; second pass: meld the results right to left
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 1 < pairs.size(); i += 2) pairs[count++] = meld(pairs[i], pairs[i + 1]);
+    if (pairs.size() % 2) pairs[count++] = pairs.back();
+    unsigned r = pairs[count - 1];
+    for (std::size_t i = count - 1; i-- > 0;) r = meld(pairs[i], r);
+    root = r;
+    return min;
+}
+
+#endif
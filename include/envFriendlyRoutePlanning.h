@@ -11,6 +11,7 @@
 #include <unordered_set>
 #include <iostream>
 #include "CreatingMap.h"
+#include "SearchWorkspace.h"
 
 /**
  * @struct EnvironmentallyFriendlyRouteResult
@@ -34,44 +35,50 @@ struct EnvironmentallyFriendlyRouteResult {
 };
 
 /**
- * @brief Marks edges (segments) in the graph as ignored based on the input list.
+ * @brief Bans edges (segments) for the current query based on the input list.
  *
- * @param avoidSegments List of edges (fromID, toID) to mark as ignored.
+ * @param map The loaded map.
+ * @param ws Workspace of the current query.
+ * @param avoidSegments List of edges (fromID, toID) to ban.
  * @note **Time Complexity:** O(S), S = number of segments to ignore.
  */
-void markIgnoredEdges(const std::vector<std::pair<int,int>>& avoidSegments);
+void markIgnoredEdges(const LoadedMap& map, SearchWorkspace& ws, const std::vector<std::pair<int,int>>& avoidSegments);
 
 /**
- * @brief Builds a path by backtracking from end to start using a map of edges.
+ * @brief Builds a path by backtracking from end to start using the edges of a search tree.
  *
  * @param startID Origin node ID.
  * @param endID Destination node ID.
  * @param driving True for driving path, false for walking.
  * @param accTime Reference to store the accumulated time.
- * @param pathMap Map of node IDs to edges representing the path.
+ * @param map The loaded map.
+ * @param tree Search tree holding the edge used to reach each node.
  * @return A list of node IDs representing the path from start to end.
  * @note **Time Complexity:** O(P), path length.
  */
-std::vector<int> buildBackwardPath(int startID, int endID, bool driving, double &accTime, const std::unordered_map<int, Edge<Location>*>& pathMap);
+std::vector<int> buildBackwardPath(int startID, int endID, bool driving, double &accTime, const LoadedMap& map, const SearchTree& tree);
 
 /**
- * @brief Builds a path from start to end using a forward map of edges.
+ * @brief Builds a path from start to end using the (reversed) edges of a search tree.
  *
  * @param startID Starting node ID.
  * @param endID Destination node ID.
  * @param driving True for driving path, false for walking.
  * @param accTime Reference to store the accumulated time.
- * @param pathMap Map of node IDs to edges representing the path.
+ * @param map The loaded map.
+ * @param tree Search tree holding the edge used to reach each node.
  * @return A list of node IDs representing the path from start to end.
  * @note **Time Complexity:** O(P), path length.
  */
-std::vector<int> buildForwardPath(int startID, int endID, bool driving, double &accTime, const std::unordered_map<int, Edge<Location>*>& pathMap);
+std::vector<int> buildForwardPath(int startID, int endID, bool driving, double &accTime, const LoadedMap& map, const SearchTree& tree);
 
 /**
  * @brief Computes an environmentally friendly route by combining driving and walking segments.
  *
  * Finds a parking location that minimizes total travel time while respecting a maximum walking time constraint.
  *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  * @param origin Origin node ID.
  * @param destination Destination node ID.
  * @param maxWalkTime Maximum allowed walking time.
@@ -80,7 +87,7 @@ std::vector<int> buildForwardPath(int startID, int endID, bool driving, double &
  * @return A structure containing the full route result.
  * @note **Time Complexity:** O((N + M) log N), N = nodes, M = edges.
  */
-EnvironmentallyFriendlyRouteResult planEnvironmentallyFriendlyRoute(int origin, int destination, int maxWalkTime,
+EnvironmentallyFriendlyRouteResult planEnvironmentallyFriendlyRoute(const LoadedMap& map, SearchWorkspace& ws, int origin, int destination, int maxWalkTime,
                                                                     const std::unordered_set<int>& ignoreVertex,
                                                                     const std::vector<std::pair<int, int>>& avoidSegments);
 
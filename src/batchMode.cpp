@@ -3,108 +3,412 @@
  * @brief Implements functionality to run route planning in batch mode using input/output files.
  */
 
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <sstream>
+#include <string_view>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 #include "../include/BatchMode.h"
 #include "../include/IndependentRoutePlanning.h"
 #include "../include/RestrictedRoutePlanning.h"
+#include "../include/envFriendlyRoutePlanning.h"
+#include "../include/TravelTimeMatrix.h"
+#include "../include/WorkStealingScheduler.h"
 
 /**
- * @brief Reads input data from a file, parses route options, and writes the result to an output file.
- *
- * Determines whether to run independent route planning (no restrictions) or restricted route planning
- * based on the parsed fields from the input file.
+ * @brief Checks whether no field of the query was set.
+ */
+bool BatchQuery::empty() const {
+    return mode.empty() && origin == -1 && destination == -1 && includeNode == -1 && maxWalkTime == -1 && k == -1 &&
+           avoidNodes.empty() && avoidSegments.empty() && sources.empty() && targets.empty() && !hasAlgorithm;
+}
+
+namespace {
+
+const char* const SPACES = " \t\r";
+
+/**
+ * @brief Advances a cursor past spaces and tabs.
+ */
+const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+/**
+ * @brief Parses an integer at the cursor, after optional spaces, and advances the cursor past it.
  *
- * @param inputFile Path to the input file containing batch route instructions.
- * @param outputFile Path to the output file where results will be written.
+ * @return Whether an integer was found.
  */
-void processInputFile(const std::string& inputFile, const std::string& outputFile) {
-    std::ifstream in(inputFile);
-    std::ofstream out(outputFile, std::ios::out | std::ios::trunc); // Create/overwrite file
+bool parseInt(const char*& p, const char* end, int& value) {
+    p = skipSpaces(p, end);
+    std::from_chars_result result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) return false;
+    p = result.ptr;
+    return true;
+}
 
-    if (!in.is_open()) {
-        std::cerr << "Error opening input file: " << inputFile << "\n";
-        return;
+/**
+ * @brief Parses a whole field value as one integer.
+ */
+bool parseIntField(const char* p, const char* end, int& value) {
+    int parsed;
+    if (!parseInt(p, end, parsed) || skipSpaces(p, end) != end) return false;
+    value = parsed;
+    return true;
+}
+
+/**
+ * @brief Parses a comma-separated list of location IDs, such as "3,7,12".
+ */
+void parseNodeList(const char* p, const char* end, std::unordered_set<int>& nodes) {
+    while (p < end) {
+        const char* comma = std::find(p, end, ',');
+        int node;
+        if (parseIntField(p, comma, node)) nodes.insert(node);
+        else std::cerr << "Invalid AvoidNode: " << std::string(p, comma) << "\n";
+        p = comma == end ? end : comma + 1;
     }
+}
 
-    if (!out.is_open()) {
-        std::cerr << "Error creating output file: " << outputFile << "\n";
-        return;
+/**
+ * @brief Parses a comma-separated list of location IDs in order, duplicates included.
+ *
+ * @param label Field name used in error messages.
+ */
+void parseIdList(const char* p, const char* end, std::vector<int>& ids, const char* label) {
+    while (p < end) {
+        const char* comma = std::find(p, end, ',');
+        int id;
+        if (parseIntField(p, comma, id)) ids.push_back(id);
+        else std::cerr << "Invalid " << label << ": " << std::string(p, comma) << "\n";
+        p = comma == end ? end : comma + 1;
     }
+}
+
+/**
+ * @brief Parses a list of segments, such as "(1,2),(3,4)". Stops at the first malformed segment.
+ */
+void parseSegmentList(const char* p, const char* end, std::vector<std::pair<int, int>>& segments) {
+    int from, to;
+    while ((p = skipSpaces(p, end)) < end && *p == '(') {
+        p++;
+        if (!parseInt(p, end, from)) break;
+        p = skipSpaces(p, end);
+        if (p == end || *p++ != ',') break;
+        if (!parseInt(p, end, to)) break;
+        p = skipSpaces(p, end);
+        if (p == end || *p++ != ')') break;
+        segments.emplace_back(from, to);
+        p = skipSpaces(p, end);
+        if (p < end && *p == ',') p++;
+    }
+}
 
-    std::string line, mode;
-    int origin = -1, destination = -1, includeNode = -1;
-    std::unordered_set<int> avoidNodes;
-    std::vector<std::pair<int, int>> avoidSegments;
+} // namespace
 
-    // Read file line by line
+/**
+ * @brief Reads the next query block.
+ *
+ * @param query Overwritten with the next query.
+ * @return False once the input holds no more queries.
+ */
+bool BatchReader::next(BatchQuery& query) {
+    query = BatchQuery();
+    if (pending) {
+        pending = false;
+        parseLine(query);
+    }
     while (std::getline(in, line)) {
-        size_t pos = line.find(':');
-        if (pos == std::string::npos) {
-            std::cerr << "Invalid line format: " << line << std::endl;
+        if (line.find_first_not_of(SPACES) == std::string::npos) {
+            if (!query.empty()) return true;
             continue;
         }
+        if (!parseLine(query)) {
+            pending = true;
+            return true;
+        }
+    }
+    return !query.empty();
+}
+
+/**
+ * @brief Adds the field on the current line to a query.
+ *
+ * @return False, leaving the query untouched, if the line is a `Mode` line that starts a new block.
+ */
+bool BatchReader::parseLine(BatchQuery& query) {
+    size_t pos = line.find(':');
+    if (pos == std::string::npos) {
+        std::cerr << "Invalid line format: " << line << std::endl;
+        return true;
+    }
+
+    // Trim spaces around the label and the value without copying the line
+    size_t labelBegin = line.find_first_not_of(SPACES);
+    size_t labelEnd = pos;
+    while (labelEnd > labelBegin && (line[labelEnd - 1] == ' ' || line[labelEnd - 1] == '\t')) labelEnd--;
+    std::string_view label(line.data() + labelBegin, labelEnd - labelBegin);
+    size_t valueBegin = std::min(line.find_first_not_of(SPACES, pos + 1), line.size());
+    size_t valueEnd = std::max(line.find_last_not_of(SPACES) + 1, valueBegin);
+    const char* value = line.data() + valueBegin;
+    const char* valueStop = line.data() + valueEnd;
+
+    // Process fields
+    if (label == "Mode") {
+        if (!query.mode.empty()) return false;
+        query.mode.assign(value, valueStop);
+    } else if (label == "Source") {
+        if (!parseIntField(value, valueStop, query.origin)) std::cerr << "Invalid Source: " << std::string(value, valueStop) << "\n";
+    } else if (label == "Destination") {
+        if (!parseIntField(value, valueStop, query.destination)) std::cerr << "Invalid Destination: " << std::string(value, valueStop) << "\n";
+    } else if (label == "AvoidNodes") {
+        parseNodeList(value, valueStop, query.avoidNodes);
+    } else if (label == "AvoidSegments") {
+        parseSegmentList(value, valueStop, query.avoidSegments);
+    } else if (label == "Sources") {
+        parseIdList(value, valueStop, query.sources, "Source");
+    } else if (label == "Targets") {
+        parseIdList(value, valueStop, query.targets, "Target");
+    } else if (label == "MaxWalkTime") {
+        if (!parseIntField(value, valueStop, query.maxWalkTime)) std::cerr << "Invalid MaxWalkTime: " << std::string(value, valueStop) << "\n";
+    } else if (label == "K") {
+        if (!parseIntField(value, valueStop, query.k) || query.k < 1) {
+            std::cerr << "Invalid K: " << std::string(value, valueStop) << "\n";
+            query.k = -1;
+        }
+    } else if (label == "IncludeNode") {
+        if (value != valueStop && !parseIntField(value, valueStop, query.includeNode)) std::cerr << "Invalid IncludeNode: " << std::string(value, valueStop) << "\n";
+    } else if (label == "Algorithm") {
+        std::string name(value, valueStop);
+        if (!parseSearchAlgorithm(name, query.algorithm)) { std::cerr << "Invalid Algorithm: " << name << "\n"; }
+        query.hasAlgorithm = true;
+    } else {
+        std::cerr << "Unknown label: " << label << "\n";
+    }
+    return true;
+}
 
-        std::string label = line.substr(0, pos);
-        std::string value = line.substr(pos + 1);
-
-        // Trim spaces
-        label.erase(0, label.find_first_not_of(" \t"));
-        label.erase(label.find_last_not_of(" \t") + 1);
-        value.erase(0, value.find_first_not_of(" \t"));
-        value.erase(value.find_last_not_of(" \t") + 1);
-
-        // Process fields
-        if (label == "Mode") {
-            mode = value;
-        } else if (label == "Source") {
-            try { origin = std::stoi(value); } catch (...) { std::cerr << "Invalid Source: " << value << "\n"; }
-        } else if (label == "Destination") {
-            try { destination = std::stoi(value); } catch (...) { std::cerr << "Invalid Destination: " << value << "\n"; }
-        } else if (label == "AvoidNodes") {
-            if (!value.empty()) {
-                std::stringstream ss(value);
-                std::string node;
-                while (std::getline(ss, node, ',')) {
-                    try { avoidNodes.insert(std::stoi(node)); } catch (...) { std::cerr << "Invalid AvoidNode: " << node << "\n"; }
-                }
+/**
+ * @brief Plans one batch query and writes its result.
+ *
+ * Computes a travel time matrix when the query lists sources or targets (walking times if its mode is `walking`,
+ * driving times otherwise), runs environmentally friendly route planning when it has a maximum walking time,
+ * independent route planning when it has no restrictions (the K fastest routes with a `K` line), and restricted
+ * route planning otherwise.
+ * A matrix query runs on the calling thread, since the queries of a batch already share the workers.
+ *
+ * @param map The loaded map.
+ * @param ws Search workspace of the calling thread.
+ * @param query The query to plan.
+ * @param out Stream receiving the result.
+ */
+void runBatchQuery(const LoadedMap& map, SearchWorkspace& ws, const BatchQuery& query, std::ostream& out) {
+    if (!query.sources.empty() || !query.targets.empty()) {
+        TravelTimeMatrix matrix = computeTravelTimeMatrix(map, ws, query.sources, query.targets, query.mode != "walking");
+        outputTravelTimeMatrix(matrix, out);
+    } else if (query.maxWalkTime != -1) {
+        EnvironmentallyFriendlyRouteResult result = planEnvironmentallyFriendlyRoute(map, ws, query.origin, query.destination, query.maxWalkTime,
+                                                                                     query.avoidNodes, query.avoidSegments);
+        outputEnvironmentallyFriendlyRouteResult(result, out);
+    } else if (query.avoidNodes.empty() && query.avoidSegments.empty() && query.includeNode == -1 && query.k != -1) {
+        RankedRoutesResult result = planKFastestRoutes(map, ws, query.origin, query.destination, query.k);
+        outputRankedRoutesResult(result, out, query.origin, query.destination);
+    } else if (query.avoidNodes.empty() && query.avoidSegments.empty() && query.includeNode == -1) {
+        IndependentRoutesResult result = planFastestRoute(map, ws, query.origin, query.destination, true, query.algorithm);
+        outputIndependentRouteResult(result, out, query.origin, query.destination);
+    } else {
+        RestrictedRoutesResult result = excludeNodesOrSegments(map, ws, query.origin, query.destination, query.avoidNodes,
+                                                               query.avoidSegments, query.includeNode, query.algorithm);
+        outputRestrictedRouteResult(result, out, query.origin, query.destination);
+    }
+}
+namespace {
+
+/**
+ * @brief Pool of workers planning batch queries, kept from one chunk of queries to the next.
+ *
+ * Queries differ a lot in cost (an environmentally friendly query runs several searches, a fastest one a single
+ * search), so they are handed out by a work-stealing scheduler rather than split once. The first worker runs on
+ * the calling thread with the given workspace; every other worker creates its own on first use, so the map is the
+ * only shared state and is only read. The scheduler's threads, the workspaces and the output buffers live as long
+ * as the planner, so a stream of chunks pays for them once.
+ */
+class BatchPlanner {
+public:
+    BatchPlanner(const LoadedMap& map, SearchWorkspace& ws, unsigned threads)
+        : map(map), ws(ws), scheduler(std::max(1u, threads)),
+          workspaces(scheduler.getNumWorkers()), outs(scheduler.getNumWorkers()) {}
+
+    /**
+     * @brief Plans the first count queries of a list.
+     *
+     * @param queries Queries to plan.
+     * @param count Number of queries to plan.
+     * @param results Resized to count and filled with the text result of each query, in input order.
+     */
+    void plan(const std::vector<BatchQuery>& queries, size_t count, std::vector<std::string>& results) {
+        results.resize(count);
+        scheduler.run(count, [&](unsigned worker, size_t i) {
+            if (worker > 0 && !workspaces[worker]) workspaces[worker].reset(new SearchWorkspace(map));
+            SearchWorkspace& workspace = worker == 0 ? ws : *workspaces[worker];
+            std::ostringstream& out = outs[worker];
+            out.str("");
+            runBatchQuery(map, workspace, queries[i], out);
+            results[i] = out.str();
+        });
+    }
+
+private:
+    const LoadedMap& map;
+    SearchWorkspace& ws;
+    WorkStealingScheduler scheduler;
+    std::vector<std::unique_ptr<SearchWorkspace>> workspaces;
+    std::vector<std::ostringstream> outs;
+};
+
+/**
+ * @brief A chunk of queries handed from the reader thread to the workers.
+ */
+struct BatchChunk {
+    std::vector<BatchQuery> queries = std::vector<BatchQuery>(BATCH_CHUNK_SIZE);
+    size_t count = 0;       ///< Number of queries read into the chunk.
+    bool ready = false;     ///< Whether the chunk was read and not yet planned.
+};
+
+} // namespace
+
+/**
+ * @brief Plans a list of batch queries on a pool of worker threads.
+ *
+ * @param map The loaded map.
+ * @param ws Search workspace of the calling thread.
+ * @param queries Queries to plan.
+ * @param threads Number of worker threads (at least 1).
+ * @return The text result of each query, in input order.
+ */
+std::vector<std::string> runBatchQueries(const LoadedMap& map, SearchWorkspace& ws, const std::vector<BatchQuery>& queries, unsigned threads) {
+    std::vector<std::string> results;
+    if (queries.empty()) return results;
+    BatchPlanner planner(map, ws, static_cast<unsigned>(std::min<size_t>(threads, queries.size())));
+    planner.plan(queries, queries.size(), results);
+    return results;
+}
+
+/**
+ * @brief Plans every query of a batch input stream, writing the results as they are ready.
+ *
+ * Two chunks of BATCH_CHUNK_SIZE queries are used in rotation: a reader thread fills one while the workers plan
+ * the other, and the calling thread writes the results of each chunk in input order and flushes the output. The
+ * planner is created once, when the first chunk is read, so its threads and workspaces serve the whole stream.
+ *
+ * @param in Stream holding the batch input.
+ * @param out Stream receiving the results.
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace used by the calling thread.
+ * @param threads Number of worker threads.
+ * @return Number of queries planned.
+ */
+size_t runBatchStream(std::istream& in, std::ostream& out, const LoadedMap& map, SearchWorkspace& ws, unsigned threads) {
+    BatchChunk chunks[2];
+    std::mutex lock;
+    std::condition_variable changed;
+
+    // A chunk with fewer than BATCH_CHUNK_SIZE queries is the last one
+    std::thread reader([&]() {
+        BatchReader batch(in);
+        for (size_t k = 0; ; k++) {
+            BatchChunk& chunk = chunks[k % 2];
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                changed.wait(guard, [&chunk]() { return !chunk.ready; });
             }
-        } else if (label == "AvoidSegments") {
-            if (!value.empty()) {
-                std::stringstream ss(value);
-                char dummy;
-                int from, to;
-                while (ss >> dummy && dummy == '(') {
-                    if (ss >> from >> dummy >> to >> dummy && dummy == ')') {
-                        avoidSegments.emplace_back(from, to);
-                    }
-                    ss >> dummy;
-                }
+            size_t count = 0;
+            while (count < BATCH_CHUNK_SIZE && batch.next(chunk.queries[count])) count++;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                chunk.count = count;
+                chunk.ready = true;
             }
-        } else if (label == "IncludeNode") {
-            try { if (!value.empty()) { includeNode = std::stoi(value); } } catch (...) { std::cerr << "Invalid IncludeNode: " << value << "\n"; }
-        } else {
-            std::cerr << "Unknown label: " << label << "\n";
+            changed.notify_all();
+            if (count < BATCH_CHUNK_SIZE) return;
+        }
+    });
+
+    std::unique_ptr<BatchPlanner> planner;
+    std::vector<std::string> results;
+    size_t planned = 0;
+    for (size_t k = 0; ; k++) {
+        BatchChunk& chunk = chunks[k % 2];
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [&chunk]() { return chunk.ready; });
+        }
+        size_t count = chunk.count;
+        if (count > 0) {
+            if (!planner) planner.reset(new BatchPlanner(map, ws, static_cast<unsigned>(std::min<size_t>(threads, count))));
+            planner->plan(chunk.queries, count, results);
         }
+
+        // The results are copied out, so the reader can refill the chunk while they are written
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            chunk.ready = false;
+        }
+        changed.notify_all();
+        for (size_t i = 0; i < count; i++) {
+            if (planned++ > 0) out << "\n";
+            out << results[i];
+        }
+        out.flush();
+        if (count < BATCH_CHUNK_SIZE) break;
     }
+    reader.join();
+    return planned;
+}
 
-    in.close();
+/**
+ * @brief Reads input data from a file, plans every query and writes the results to an output file.
+ *
+ * Results are written in input order, separated by a blank line, so an input with a single query
+ * produces exactly the same output as before.
+ *
+ * @param inputFile Path to the input file containing batch route instructions, or "-" for standard input.
+ * @param outputFile Path to the output file where results will be written, or "-" for standard output.
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
+ * @param threads Number of worker threads.
+ */
+void processInputFile(const std::string& inputFile, const std::string& outputFile, const LoadedMap& map, SearchWorkspace& ws,
+                      unsigned threads) {
+    std::ifstream inFile;
+    std::ofstream outFile;
+    if (inputFile != "-") inFile.open(inputFile);
+    if (outputFile != "-") outFile.open(outputFile, std::ios::out | std::ios::trunc); // Create/overwrite file
 
-    // Determine which function to call based on input data
-    if (avoidNodes.empty() && avoidSegments.empty() && includeNode == -1) {
-        std::cout << "Calling Independent Route Planning...\n";
-        IndependentRoutesResult result = planFastestRoute(origin, destination, true);
-        outputIndependentRouteResult(result, out, origin, destination);
-    } else {
-        std::cout << "Calling Restricted Route Planning...\n";
-        RestrictedRoutesResult result = excludeNodesOrSegments(origin, destination, avoidNodes, avoidSegments, includeNode);
-        outputRestrictedRouteResult(result, out, origin, destination);
+    if (inputFile != "-" && !inFile.is_open()) {
+        std::cerr << "Error opening input file: " << inputFile << "\n";
+        return;
+    }
+
+    if (outputFile != "-" && !outFile.is_open()) {
+        std::cerr << "Error creating output file: " << outputFile << "\n";
+        return;
     }
 
-    out.close();
+    std::istream& in = inputFile == "-" ? std::cin : inFile;
+    std::ostream& out = outputFile == "-" ? std::cout : outFile;
+    std::ostream& log = outputFile == "-" ? std::cerr : std::cout;
+
+    size_t planned = runBatchStream(in, out, map, ws, threads);
+    log << "Planned " << planned << " route" << (planned == 1 ? "" : "s") << " on up to " << std::max(1u, threads) << " thread(s)\n";
 }
 
 /**
@@ -112,17 +416,23 @@ void processInputFile(const std::string& inputFile, const std::string& outputFil
  *
  * Validates the input file and triggers the processing of instructions.
  *
- * @param inputFile Path to the input file with route instructions.
- * @param outputFile Path to the output file (default is "output.txt").
+ * @param inputFile Path to the input file with route instructions, or "-" for standard input.
+ * @param outputFile Path to the output file (default is "output.txt"), or "-" for standard output.
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
+ * @param threads Number of worker threads.
  */
-void runBatchMode(const std::string& inputFile, const std::string& outputFile) {
-    std::ifstream in(inputFile);
-    if (!in.is_open()) {
-        std::cerr << "Error: Cannot open input file: " << inputFile << "\n";
-        return;
+void runBatchMode(const std::string& inputFile, const std::string& outputFile, const LoadedMap& map, SearchWorkspace& ws,
+                  unsigned threads) {
+    if (inputFile != "-") {
+        std::ifstream in(inputFile);
+        if (!in.is_open()) {
+            std::cerr << "Error: Cannot open input file: " << inputFile << "\n";
+            return;
+        }
+        in.close();
     }
-    in.close();
 
     // Process the input file and write the result
-    processInputFile(inputFile, outputFile);
+    processInputFile(inputFile, outputFile, map, ws, threads);
 }
@@ -7,102 +7,429 @@
 
 #include <iostream>
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <string_view>
 #include <unordered_map>
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
 #include "../include/data_structures/Graph.h"
 #include "../include/CreatingMap.h"
 #include "../include/Location.h"
+#include "../include/MappedFile.h"
+#include "../include/MapFile.h"
+#include "../include/WorkStealingScheduler.h"
+#include "../include/data_structures/CodeIndex.h"
 
 #define INF std::numeric_limits<double>::max()
 
+// Smallest chunk of Distances.csv parsed by one thread, in bytes
+#define MIN_PARSE_CHUNK (1 << 20)
+
+namespace {
+
+/**
+ * @brief Returns the next line of a mapped file, without its line break, and advances the cursor past it.
+ *
+ * @param p Cursor into the file.
+ * @param end End of the file.
+ * @param line Set to the line, pointing into the file.
+ * @return False at the end of the file.
+ */
+bool nextLine(const char*& p, const char* end, std::string_view& line) {
+    if (p >= end) return false;
+    const char* stop = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (stop == nullptr) stop = end;
+    const char* last = stop;
+    if (last > p && last[-1] == '\r') last--;
+    line = std::string_view(p, last - p);
+    p = stop == end ? end : stop + 1;
+    return true;
+}
+
+/**
+ * @brief Splits a line on commas, in place.
+ *
+ * @param line The line to split.
+ * @param fields Receives up to max fields; the last one stops at the next comma, like the others.
+ * @param max Number of fields wanted.
+ * @return Number of fields found.
+ */
+size_t splitFields(std::string_view line, std::string_view* fields, size_t max) {
+    size_t count = 0;
+    size_t start = 0;
+    while (count < max) {
+        size_t comma = line.find(',', start);
+        fields[count++] = line.substr(start, comma == std::string_view::npos ? std::string_view::npos : comma - start);
+        if (comma == std::string_view::npos) break;
+        start = comma + 1;
+    }
+    return count;
+}
+
+/**
+ * @brief Removes leading and trailing spaces from a field.
+ */
+std::string_view trim(std::string_view field) {
+    while (!field.empty() && (field.front() == ' ' || field.front() == '\t')) field.remove_prefix(1);
+    while (!field.empty() && (field.back() == ' ' || field.back() == '\t')) field.remove_suffix(1);
+    return field;
+}
+
+/**
+ * @brief Parses a whole field as a number, ignoring surrounding spaces.
+ *
+ * @return False if the field is not a number.
+ */
+template <typename Number>
+bool parseField(std::string_view field, Number& value) {
+    field = trim(field);
+    if (!field.empty() && field.front() == '+') field.remove_prefix(1);
+    std::from_chars_result result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size() && !field.empty();
+}
+
+/**
+ * @brief A distance row, resolved to the dense indices of its locations.
+ */
+struct Segment {
+    unsigned source;
+    unsigned destination;
+    double driving;
+    double walking;
+};
+
 /**
- * @brief Global map from location IDs to their corresponding graph vertices.
+ * @brief Parses the rows of one chunk of Distances.csv.
+ *
+ * Rows with an unknown location are dropped, like in the graph.
+ *
+ * @param p Start of the chunk, at the beginning of a line.
+ * @param end End of the chunk, just after a line break or at the end of the file.
+ * @param codes Index from location codes to vertex indices, only read.
+ * @param segments Receives the segments of the chunk, in file order.
+ * @return Number of malformed rows.
  */
-std::unordered_map<int, Vertex<Location>*> idmap;
+size_t parseDistances(const char* p, const char* end, const CodeIndex& codes, std::vector<Segment>& segments) {
+    std::string_view line, fields[4];
+    std::string_view lastSource;
+    unsigned lastIndex = CodeIndex::NONE;
+    size_t skipped = 0;
+    while (nextLine(p, end, line)) {
+        if (splitFields(line, fields, 4) < 4) continue;
+
+        double driveTime, walkTime;
+        if (trim(fields[2]) == "X") driveTime = INF;
+        else if (!parseField(fields[2], driveTime)) {
+            skipped++;
+            continue;
+        }
+        if (!parseField(fields[3], walkTime)) {
+            skipped++;
+            continue;
+        }
+
+        // Rows are usually grouped by source, so the previous lookup is reused when the code repeats
+        unsigned src = fields[0] == lastSource && !lastSource.empty() ? lastIndex : codes.find(fields[0]);
+        unsigned dest = codes.find(fields[1]);
+        lastSource = fields[0];
+        lastIndex = src;
+
+        if (src != CodeIndex::NONE && dest != CodeIndex::NONE) {
+            segments.push_back({src, dest, driveTime, walkTime});
+        }
+    }
+    return skipped;
+}
+
+} // namespace
 
 /**
  * @brief Reads location data from a file and populates the graph with vertices.
  * 
  * Each location is inserted into the graph and stored in a map for reference by code and ID.
+ * Two optional trailing columns (Latitude, Longitude) give the coordinates of the location.
+ * The file is memory-mapped and tokenized in place; only the name and code of each location are copied.
  *
  * @param map Reference to the graph to populate.
  * @param locations Map to store references to created vertices using their string codes.
+ * @param idmap Map to store references to created vertices using their IDs.
+ * @param path Path to the locations file.
  */
-void readLocations(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations) {
-    std::ifstream LocationsFile("../data/Locations.csv");
-    if (!LocationsFile.is_open()) {
+void readLocations(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations,
+                   std::unordered_map<int, Vertex<Location>*>& idmap, const std::string& path) {
+    MappedFile LocationsFile;
+    if (!LocationsFile.open(path)) {
         std::cerr << "Error opening Locations.csv" << std::endl;
         exit(1);
     }
 
-    std::string line;
-    std::getline(LocationsFile, line);  // Ignore header
+    const char* p = LocationsFile.begin();
+    std::string_view line, fields[6];
+    nextLine(p, LocationsFile.end(), line);  // Ignore header
+
+    size_t skipped = 0;
+    while (nextLine(p, LocationsFile.end(), line)) {
+        size_t count = splitFields(line, fields, 6);
+        if (count < 4) continue;
 
-    while (std::getline(LocationsFile, line)) {
-        std::istringstream iss(line);
-        std::string name, id, code, parking;
+        int id, parking;
+        if (!parseField(fields[1], id) || !parseField(fields[3], parking)) {
+            skipped++;
+            continue;
+        }
+        Location location{std::string(fields[0]), id, std::string(fields[2]), parking};
 
-        if (std::getline(iss, name, ',') && std::getline(iss, id, ',') &&
-            std::getline(iss, code, ',') && std::getline(iss, parking, ',')) {
-            Location location{name, std::stoi(id), code, std::stoi(parking)};
-            map.addVertex(location);
-            locations[code] = map.findVertex(location);  // Storing a pointer instead of a copy
-            idmap[std::stoi(id)] = map.findVertex(location);
+        // Optional Latitude,Longitude columns
+        double latitude, longitude;
+        if (count == 6 && parseField(fields[4], latitude) && parseField(fields[5], longitude)) {
+            location.setCoordinates(latitude, longitude);
         }
+        map.addVertex(location);
+        Vertex<Location>* vertex = map.findVertex(location);  // Storing a pointer instead of a copy
+        locations[location.code] = vertex;
+        idmap[id] = vertex;
     }
 
-    LocationsFile.close();
+    if (skipped > 0) std::cerr << "Skipped " << skipped << " malformed rows in " << path << std::endl;
 }
 
 /**
  * @brief Reads distance data from a file and adds bidirectional edges to the graph.
  * 
  * For each entry, edges are added between the corresponding locations with driving and walking times.
+ * A driving time of `X` marks a segment that cannot be driven.
+ *
+ * The file is memory-mapped and split at line breaks into chunks, which are tokenized in place on several threads.
+ * Each chunk is parsed into its own buffer of segments, with location codes looked up in a shared, read-only
+ * CodeIndex. The buffers are then added to the graph in file order, so the graph is the same whatever the number
+ * of threads, after sizing every adjacency list once.
  *
  * @param map Reference to the graph to populate.
  * @param locations Map containing references to existing vertices (from `readLocations`).
+ * @param path Path to the distances file.
+ * @param threads Number of parsing threads, 0 for one per core.
  */
-void readDistances(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations) {
-    std::ifstream DistancesFile("../data/Distances.csv");
-    if (!DistancesFile.is_open()) {
+void readDistances(Graph<Location>& map, std::unordered_map<std::string, Vertex<Location>*>& locations, const std::string& path,
+                   unsigned threads) {
+    MappedFile DistancesFile;
+    if (!DistancesFile.open(path)) {
         std::cerr << "Error opening Distances.csv" << std::endl;
         exit(1);
     }
 
-    std::string line;
-    std::getline(DistancesFile, line);  // Ignore header
+    CodeIndex codes;
+    codes.reserve(locations.size());
+    for (const auto& entry : locations) {
+        if (entry.second) codes.insert(entry.first, entry.second->getIndex());
+    }
+
+    const char* p = DistancesFile.begin();
+    const char* end = DistancesFile.end();
+    std::string_view line;
+    nextLine(p, end, line);  // Ignore header
+
+    // Split the rows into chunks of at least MIN_PARSE_CHUNK bytes, a few per thread so that they balance out
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t numChunks = std::max<size_t>(1, std::min<size_t>(4 * threads, (end - p) / MIN_PARSE_CHUNK));
+    std::vector<const char*> bounds{p};
+    for (size_t c = 1; c < numChunks; c++) {
+        const char* cut = std::max(bounds.back(), p + (end - p) * c / numChunks);
+        const char* lineEnd = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+        bounds.push_back(lineEnd == nullptr ? end : lineEnd + 1);
+    }
+    bounds.push_back(end);
+
+    std::vector<std::vector<Segment>> segments(numChunks);
+    std::vector<size_t> skipped(numChunks, 0);
+    WorkStealingScheduler scheduler(static_cast<unsigned>(std::min<size_t>(threads, numChunks)));
+    scheduler.run(numChunks, [&](unsigned, size_t c) {
+        segments[c].reserve((bounds[c + 1] - bounds[c]) / 16);
+        skipped[c] = parseDistances(bounds[c], bounds[c + 1], codes, segments[c]);
+    });
+
+    // Every segment adds an outgoing and an incoming edge at both ends
+    std::vector<unsigned> degree(map.getNumVertex(), 0);
+    for (const auto& chunk : segments) {
+        for (const Segment& segment : chunk) {
+            degree[segment.source]++;
+            degree[segment.destination]++;
+        }
+    }
+    for (int v = 0; v < map.getNumVertex(); v++) {
+        if (degree[v] > 0) map.getVertex(v)->reserveEdges(degree[v], degree[v]);
+    }
 
-    while (std::getline(DistancesFile, line)) {
-        std::istringstream iss(line);
-        std::string source, destination, driving, walking;
+    size_t malformed = 0;
+    for (size_t c = 0; c < numChunks; c++) {
+        for (const Segment& segment : segments[c]) {
+            map.addBidirectionalEdge(map.getVertex(segment.source), map.getVertex(segment.destination), segment.driving, segment.walking);
+        }
+        std::vector<Segment>().swap(segments[c]);   // release each buffer as soon as it is merged
+        malformed += skipped[c];
+    }
 
-        if (std::getline(iss, source, ',') && std::getline(iss, destination, ',') &&
-            std::getline(iss, driving, ',') && std::getline(iss, walking, ',')) {
+    if (malformed > 0) std::cerr << "Skipped " << malformed << " malformed rows in " << path << std::endl;
+}
 
-            double driveTime = (driving == "X") ? INF : std::stod(driving);
-            double walkTime = std::stod(walking);
+/**
+ * @brief Reads the optional coordinates side file and attaches the coordinates to the existing locations.
+ *
+ * Each line holds a location ID, a latitude and a longitude. If the file does not exist nothing is done,
+ * since coordinates are only needed by the goal-directed searches.
+ *
+ * @param idmap Map of location IDs to existing vertex pointers (from `readLocations`).
+ * @param path Path to the coordinates file.
+ */
+void readCoordinates(std::unordered_map<int, Vertex<Location>*>& idmap, const std::string& path) {
+    MappedFile CoordinatesFile;
+    if (!CoordinatesFile.open(path)) {
+        return;
+    }
 
-            Vertex<Location>* src = locations[source];
-            Vertex<Location>* dest = locations[destination];
+    const char* p = CoordinatesFile.begin();
+    std::string_view line, fields[3];
+    nextLine(p, CoordinatesFile.end(), line);  // Ignore header
 
-            if (src && dest) {
-                map.addBidirectionalEdge(src->getInfo(), dest->getInfo(), driveTime, walkTime);
+    while (nextLine(p, CoordinatesFile.end(), line)) {
+        int id;
+        double latitude, longitude;
+        if (splitFields(line, fields, 3) == 3 && parseField(fields[0], id) && parseField(fields[1], latitude) &&
+            parseField(fields[2], longitude)) {
+            auto it = idmap.find(id);
+            if (it != idmap.end()) {
+                Location location = it->second->getInfo();
+                location.setCoordinates(latitude, longitude);
+                it->second->setInfo(location);
             }
         }
     }
+}
+
+int LoadedMap::indexOf(int id) const {
+    size_t n = ids.size();
+    if (n == 0) return -1;
+
+    // IDs numbered without gaps, as in the bundled data, are looked up by position
+    long long first = ids[0].id;
+    if (ids[n - 1].id - first == static_cast<long long>(n) - 1) {
+        return id < first || id - first >= static_cast<long long>(n) ? -1 : static_cast<int>(ids[id - first].index);
+    }
+    const LocationId* it = std::lower_bound(ids.begin(), ids.end(), id,
+                                            [](const LocationId& entry, int value) { return entry.id < value; });
+    return it != ids.end() && it->id == id ? static_cast<int>(it->index) : -1;
+}
+
+int LoadedMap::indexOfCode(std::string_view code) const {
+    const unsigned* it = std::lower_bound(codes.begin(), codes.end(), code,
+                                          [this](unsigned v, std::string_view value) { return csr.getInfo(v).code < value; });
+    return it != codes.end() && csr.getInfo(*it).code == code ? static_cast<int>(*it) : -1;
+}
+
+/**
+ * @brief Sorts the dense vertex indices by location ID and by location code.
+ *
+ * @param map LoadedMap whose CSR snapshot is already built.
+ */
+void indexLocations(LoadedMap& map) {
+    const CsrGraph<Location>& csr = map.csr;
+    unsigned n = csr.getNumVertex();
+
+    std::vector<LocationId> ids(n);
+    for (unsigned v = 0; v < n; v++) ids[v] = LocationId{csr.getInfo(v).id, v};
+    std::sort(ids.begin(), ids.end(), [](const LocationId& a, const LocationId& b) { return a.id < b.id; });
+    map.ids.assign(std::move(ids));
+
+    std::vector<unsigned> codes(n);
+    for (unsigned v = 0; v < n; v++) codes[v] = v;
+    std::sort(codes.begin(), codes.end(), [&csr](unsigned a, unsigned b) { return csr.getInfo(a).code < csr.getInfo(b).code; });
+    map.codes.assign(std::move(codes));
+}
+
+/**
+ * @brief Computes the fastest speed of any edge, per metric, used to bound travel times from coordinates.
+ *
+ * The speed of an edge is the straight-line distance between its endpoints divided by its time.
+ * If a location lacks coordinates, or an edge has zero time between distinct points, no bound exists
+ * and the speed is left at 0, which disables the goal-directed heuristic for that metric.
+ *
+ * @param map LoadedMap whose CSR snapshot is already built.
+ */
+void computeSpeedBounds(LoadedMap& map) {
+    const CsrGraph<Location>& csr = map.csr;
+    map.maxDrivingSpeed = 0;
+    map.maxWalkingSpeed = 0;
+    for (unsigned v = 0; v < csr.getNumVertex(); v++) {
+        if (!csr.getInfo(v).hasCoordinates) return;
+    }
 
-    DistancesFile.close();
+    double driving = 0, walking = 0;
+    for (unsigned e = 0; e < csr.getNumEdges(); e++) {
+        double length = straightLineDistance(csr.getInfo(csr.getSource(e)), csr.getInfo(csr.getTarget(e)));
+        if (length == 0) continue;
+        if (csr.getDriving(e) != INF) driving = std::max(driving, csr.getDriving(e) > 0 ? length / csr.getDriving(e) : INF);
+        if (csr.getWalking(e) != INF) walking = std::max(walking, csr.getWalking(e) > 0 ? length / csr.getWalking(e) : INF);
+    }
+    map.maxDrivingSpeed = driving == INF ? 0 : driving;
+    map.maxWalkingSpeed = walking == INF ? 0 : walking;
 }
 
 /**
- * @brief Initializes the full graph by reading both locations and distances from files.
+ * @brief Detects, per metric, whether Dijkstra can order vertices with a bucket queue.
+ *
+ * Only edges open to driving count, since the searches skip the others. A metric qualifies when every
+ * such weight is a whole number between 0 and MAX_BUCKET_WEIGHT.
+ *
+ * @param map LoadedMap whose CSR snapshot is already built.
+ */
+void detectIntegralWeights(LoadedMap& map) {
+    const CsrGraph<Location>& csr = map.csr;
+    for (int driving = 0; driving < 2; driving++) {
+        bool integral = true;
+        double max = 0;
+        for (unsigned e = 0; e < csr.getNumEdges() && integral; e++) {
+            if (csr.getDriving(e) == INF) continue;
+            double w = driving ? csr.getDriving(e) : csr.getWalking(e);
+            integral = w >= 0 && w <= MAX_BUCKET_WEIGHT && w == std::floor(w);
+            max = std::max(max, w);
+        }
+        map.integralWeights[driving] = integral;
+        map.maxWeight[driving] = integral ? static_cast<unsigned>(max) : 0;
+    }
+}
+
+/**
+ * @brief Initializes the full map by reading both locations and distances from files.
  * 
- * @param map Graph reference to be filled with vertices and edges.
+ * @param map LoadedMap reference to be filled with vertices, edges, the CSR snapshot, the location indices and the speed bounds.
  */
-void createMap(Graph<Location>& map) {
+void createMapFromCsv(LoadedMap& map) {
     std::unordered_map<std::string, Vertex<Location>*> locations;
+    std::unordered_map<int, Vertex<Location>*> idmap;
+
+    readLocations(map.graph, locations, idmap);
+    readCoordinates(idmap);
+    readDistances(map.graph, locations);
+    map.csr.build(map.graph);
+    indexLocations(map);
+    detectIntegralWeights(map);
+    computeSpeedBounds(map);
+}
 
-    readLocations(map, locations);
-    readDistances(map, locations);
+/**
+ * @brief Maps the binary map file if it was written from the current data files; otherwise parses the CSV files
+ * and writes the map file for the next start.
+ *
+ * @param map LoadedMap reference to be filled.
+ */
+void createMap(LoadedMap& map) {
+    const std::vector<std::string> sources = {LOCATIONS_FILE, DISTANCES_FILE, COORDINATES_FILE};
+    if (loadMapFile(map, MAP_FILE, sources)) return;
+
+    createMapFromCsv(map);
+    if (!saveMapFile(map, MAP_FILE, sources)) {
+        std::cerr << "Warning: could not write " << MAP_FILE << std::endl;
+    }
 }
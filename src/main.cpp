@@ -1,8 +1,13 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <thread>
 #include "../include/Menu.h"
 #include "../include/BatchMode.h"
+#include "../include/CreatingMap.h"
+#include "../include/SearchWorkspace.h"
+#include "../include/Landmarks.h"
+#include "../include/AllPairsTable.h"
 
 /**
  * @file main.cpp
@@ -10,6 +15,8 @@
  *
  * If command-line arguments are provided, the application runs in batch mode, processing input and output files.
  * If no arguments are given, it launches an interactive menu for user interaction.
+ * The option --all-pairs, given before the other arguments, also precomputes the travel times between all pairs
+ * of locations, so Dijkstra queries without restrictions become table lookups.
  */
 
 /**
@@ -17,25 +24,46 @@
  *
  * @param argc Argument count.
  * @param argv Argument vector.
- *        - argv[1]: Path to the input file (optional).
- *        - argv[2]: Path to the output file (optional, defaults to "../output.txt").
+ *        - --all-pairs: Prepare the all-pairs table (optional, must come first).
+ *        - argv[1]: Path to the input file (optional, "-" for standard input).
+ *        - argv[2]: Path to the output file (optional, defaults to "../output.txt", "-" for standard output).
+ *        - argv[3]: Number of worker threads for batch mode (optional, defaults to the number of cores).
  *
  * @return int Exit status.
  */
 int main(int argc, char* argv[]) {
+    // The map is loaded once and shared by every query of this process
+    LoadedMap map;
+    createMap(map);
+    SearchWorkspace ws(map);
+    prepareLandmarks(map, ws);
+
+    if (argc > 1 && std::string(argv[1]) == "--all-pairs") {
+        prepareAllPairsTable(map, ws);
+        argc--;
+        argv++;
+    }
+
     if (argc > 1) {
         // Batch mode: Process input file and create output file
         std::string inputFile = argv[1];
         std::string outputFile = (argc > 2) ? argv[2] : "../output.txt"; // Use given output file or default
+        unsigned threads = std::thread::hardware_concurrency();
+        if (argc > 3) {
+            try { threads = static_cast<unsigned>(std::stoul(argv[3])); } catch (...) { std::cerr << "Invalid thread count: " << argv[3] << "\n"; }
+        }
+        if (threads == 0) threads = 1;
 
-        std::cout << "Running in batch mode with input file: " << inputFile << std::endl;
-        std::cout << "Output will be written to: " << outputFile << std::endl;
+        // Results may go to standard output ("-"), so status messages go to standard error then
+        std::ostream& log = outputFile == "-" ? std::cerr : std::cout;
+        log << "Running in batch mode with input file: " << inputFile << std::endl;
+        log << "Output will be written to: " << outputFile << std::endl;
 
-        runBatchMode(inputFile, outputFile); // Call batch mode function
+        runBatchMode(inputFile, outputFile, map, ws, threads); // Call batch mode function
     } else {
         // No arguments provided: Run interactive menu mode
         std::cout << "Launching interactive mode...\n";
-        handleMenuSelection(); // Open the menu
+        handleMenuSelection(map, ws); // Open the menu
     }
 
     return 0;
@@ -13,6 +13,7 @@
 #include <sstream>
 #include <fstream>
 
+#include "../include/BatchMode.h"
 #include "../include/CreatingMap.h"
 #include "../include/Menu.h"
 #include "../include/RestrictedRoutePlanning.h"
@@ -21,21 +22,27 @@
 
 /**
  * @brief Handles manual input for planning the fastest route.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void planFastestRouteMenu() {
+void planFastestRouteMenu(const LoadedMap& map, SearchWorkspace& ws) {
     int origin, destination;
     std::cout << "Enter the origin location ID: ";
     std::cin >> origin;
     std::cout << "Enter the destination location ID: ";
     std::cin >> destination;
-    IndependentRoutesResult result = planFastestRoute(origin, destination, true);
+    IndependentRoutesResult result = planFastestRoute(map, ws, origin, destination, true);
     outputIndependentRouteResult(result, std::cout, origin, destination);
 }
 
 /**
  * @brief Handles batch input from a file for planning the fastest route.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void planFastestRouteBatch() {
+void planFastestRouteBatch(const LoadedMap& map, SearchWorkspace& ws) {
     std::ifstream inputFile("../input.txt");
     std::ofstream outputFile("../output.txt");
 
@@ -55,53 +62,26 @@ void planFastestRouteBatch() {
         outputFile.open("../output.txt", std::ios::app);
     }
 
-    std::string line;
-    int origin = -1, destination = -1;
-
-    while (std::getline(inputFile, line)) {
-        size_t pos = line.find(':');
-        if (pos == std::string::npos) {
-            std::cerr << "Invalid line format: " << line << std::endl;
-            continue;
-        }
-
-        std::string label = line.substr(0, pos);
-        std::string value = line.substr(pos + 1);
-
-        label.erase(0, label.find_first_not_of(" \t"));
-        label.erase(label.find_last_not_of(" \t") + 1);
-        value.erase(0, value.find_first_not_of(" \t"));
-        value.erase(value.find_last_not_of(" \t") + 1);
-
-        if (label == "Mode") {
-        } else if (label == "Source") {
-            try {
-                origin = std::stoi(value);
-            } catch (...) {
-                std::cerr << "Error: Invalid source value: " << value << std::endl;
-            }
-        } else if (label == "Destination") {
-            try {
-                destination = std::stoi(value);
-            } catch (...) {
-                std::cerr << "Error: Invalid destination value: " << value << std::endl;
-            }
-        } else {
-            std::cerr << "Unknown label: " << label << std::endl;
-        }
+    // Every block of the file is planned as it is read, so the file may hold any number of queries
+    BatchReader reader(inputFile);
+    BatchQuery query;
+    for (bool first = true; reader.next(query); first = false) {
+        if (!first) outputFile << "\n";
+        IndependentRoutesResult result = planFastestRoute(map, ws, query.origin, query.destination, true, query.algorithm);
+        outputIndependentRouteResult(result, outputFile, query.origin, query.destination);
     }
 
-    IndependentRoutesResult result = planFastestRoute(origin, destination, true);
-    outputIndependentRouteResult(result, outputFile, origin, destination);
-
     inputFile.close();
     outputFile.close();
 }
 
 /**
  * @brief Handles manual input for planning an environmentally friendly route.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void planEnvironmentallyFriendlyRouteMenu() {
+void planEnvironmentallyFriendlyRouteMenu(const LoadedMap& map, SearchWorkspace& ws) {
     int origin, destination, maxWalkTime;
     std::unordered_set<int> avoidNodes;
     std::vector<std::pair<int, int>> avoidSegments;
@@ -139,14 +119,17 @@ void planEnvironmentallyFriendlyRouteMenu() {
         }
     }
 
-    EnvironmentallyFriendlyRouteResult result = planEnvironmentallyFriendlyRoute(origin, destination, maxWalkTime, avoidNodes, avoidSegments);
+    EnvironmentallyFriendlyRouteResult result = planEnvironmentallyFriendlyRoute(map, ws, origin, destination, maxWalkTime, avoidNodes, avoidSegments);
     outputEnvironmentallyFriendlyRouteResult(result, std::cout);
 }
 
 /**
  * @brief Handles batch input from a file for planning an environmentally friendly route.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void planEnvironmentallyFriendlyRouteBatch() {
+void planEnvironmentallyFriendlyRouteBatch(const LoadedMap& map, SearchWorkspace& ws) {
     std::ifstream inputFile("../input.txt");
     std::ofstream outputFile("../output.txt", std::ios::app);
 
@@ -166,88 +149,27 @@ void planEnvironmentallyFriendlyRouteBatch() {
         outputFile.open("../output.txt", std::ios::app);
     }
 
-    std::string line;
-    int origin = -1, destination = -1, maxWalkTime = -1;
-    std::unordered_set<int> avoidNodes;
-    std::vector<std::pair<int, int>> avoidSegments;
-
-    while (std::getline(inputFile, line)) {
-        size_t pos = line.find(':');
-        if (pos == std::string::npos) {
-            std::cerr << "Invalid line format: " << line << std::endl;
-            continue;
-        }
-
-        std::string label = line.substr(0, pos);
-        std::string value = line.substr(pos + 1);
-
-        label.erase(0, label.find_first_not_of(" \t\r\n"));
-        label.erase(label.find_last_not_of(" \t\r\n") + 1);
-        value.erase(0, value.find_first_not_of(" \t\r\n"));
-        value.erase(value.find_last_not_of(" \t\r\n") + 1);
-
-        if (label == "Mode") {
-        }
-        else if (label == "Source") {
-            try {
-                origin = std::stoi(value);
-            } catch (...) {
-                std::cerr << "Error: Invalid source value: " << value << std::endl;
-            }
-        }
-        else if (label == "Destination") {
-            try {
-                destination = std::stoi(value);
-            } catch (...) {
-                std::cerr << "Error: Invalid destination value: " << value << std::endl;
-            }
-        }
-        else if (label == "MaxWalkTime") {
-            try {
-                maxWalkTime = std::stoi(value);
-            } catch (...) {
-                std::cerr << "Error: Invalid source value: " << value << std::endl;
-            }
-        }
-        else if (label == "AvoidNodes") {
-            if (!value.empty()) {
-                std::stringstream ss(value);
-                std::string node;
-                while (std::getline(ss, node, ',')) {
-                    try {
-                        avoidNodes.insert(std::stoi(node));
-                    } catch (...) {
-                        std::cerr << "Error: Invalid avoid node: " << node << std::endl;
-                    }
-                }
-            }
-        }
-        else if (label == "AvoidSegments") {
-            if (!value.empty()) {
-                std::stringstream ss(value);
-                char dummy;
-                int from, to;
-                while (ss >> dummy && dummy == '(') {
-                    if (ss >> from >> dummy >> to >> dummy && dummy == ')') {
-                        avoidSegments.emplace_back(from, to);
-                    }
-                    ss >> dummy;
-                }
-            }
-        }
+    // Every block of the file is planned as it is read, so the file may hold any number of queries
+    BatchReader reader(inputFile);
+    BatchQuery query;
+    for (bool first = true; reader.next(query); first = false) {
+        if (!first) outputFile << "\n";
+        EnvironmentallyFriendlyRouteResult result = planEnvironmentallyFriendlyRoute(map, ws, query.origin, query.destination, query.maxWalkTime,
+                                                                                     query.avoidNodes, query.avoidSegments);
+        outputEnvironmentallyFriendlyRouteResult(result, outputFile);
     }
 
-    EnvironmentallyFriendlyRouteResult result = planEnvironmentallyFriendlyRoute(origin, destination, maxWalkTime, avoidNodes, avoidSegments);
-    outputEnvironmentallyFriendlyRouteResult(result, outputFile);
-
     inputFile.close();
     outputFile.close();
 }
 
 /**
  * @brief Handles manual input for restricted route planning.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void excludeNodesOrSegmentsMenu() {
+void excludeNodesOrSegmentsMenu(const LoadedMap& map, SearchWorkspace& ws) {
     int origin, destination;
     std::unordered_set<int> avoidNodes;
     std::vector<std::pair<int, int>> avoidSegments;
@@ -292,14 +214,17 @@ void excludeNodesOrSegmentsMenu() {
         include = std::stoi(input);
     }
 
-    RestrictedRoutesResult result = excludeNodesOrSegments(origin, destination, avoidNodes, avoidSegments, include);
+    RestrictedRoutesResult result = excludeNodesOrSegments(map, ws, origin, destination, avoidNodes, avoidSegments, include);
     outputRestrictedRouteResult(result, std::cout, origin, destination);
 }
 
 /**
  * @brief Handles batch input from a file for restricted route planning.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void excludeNodesOrSegmentsBatch() {
+void excludeNodesOrSegmentsBatch(const LoadedMap& map, SearchWorkspace& ws) {
     std::ifstream inputFile("../input.txt");
     std::ofstream outputFile("../output.txt", std::ios::app);
 
@@ -319,95 +244,27 @@ void excludeNodesOrSegmentsBatch() {
         outputFile.open("../output.txt", std::ios::app);
     }
 
-    std::string line, mode;
-    int origin = -1, destination = -1, include = -1;
-    std::unordered_set<int> avoidNodes;
-    std::vector<std::pair<int, int>> avoidSegments;
-
-    while (std::getline(inputFile, line)) {
-        size_t pos = line.find(':');
-        if (pos == std::string::npos) {
-            std::cerr << "Invalid line format: " << line << std::endl;
-            continue;
-        }
-
-        std::string label = line.substr(0, pos);
-        std::string value = line.substr(pos + 1);
-
-        label.erase(0, label.find_first_not_of(" \t\r\n"));
-        label.erase(label.find_last_not_of(" \t\r\n") + 1);
-        value.erase(0, value.find_first_not_of(" \t\r\n"));
-        value.erase(value.find_last_not_of(" \t\r\n") + 1);
-
-        if (label == "Mode") {
-            mode = value;
-        }
-        else if (label == "Source") {
-            try {
-                origin = std::stoi(value);
-            } catch (...) {
-                std::cerr << "Error: Invalid source value: " << value << std::endl;
-            }
-        }
-        else if (label == "Destination") {
-            try {
-                destination = std::stoi(value);
-            } catch (...) {
-                std::cerr << "Error: Invalid destination value: " << value << std::endl;
-                continue;
-            }
-        }
-        else if (label == "AvoidNodes") {
-            if (!value.empty()) {
-                std::stringstream ss(value);
-                std::string node;
-                while (std::getline(ss, node, ',')) {
-                    try {
-                        avoidNodes.insert(std::stoi(node));
-                    } catch (...) {
-                        std::cerr << "Error: Invalid avoid node: " << node << std::endl;
-                    }
-                }
-            }
-        }
-        else if (label == "AvoidSegments") {
-            if (!value.empty()) {
-                std::stringstream ss(value);
-                char dummy;
-                int from, to;
-                while (ss >> dummy && dummy == '(') {
-                    if (ss >> from >> dummy >> to >> dummy && dummy == ')') {
-                        avoidSegments.emplace_back(from, to);
-                    }
-                    ss >> dummy;
-                }
-            }
-        }
-        else if (label == "IncludeNode") {
-            try {
-                if (!value.empty()) {
-                    include = std::stoi(value);
-                }
-            } catch (...) {
-                std::cerr << "Error: Invalid include node: " << value << std::endl;
-            }
-        }
-        else {
-            std::cerr << "Unknown label: " << label << std::endl;
-        }
+    // Every block of the file is planned as it is read, so the file may hold any number of queries
+    BatchReader reader(inputFile);
+    BatchQuery query;
+    for (bool first = true; reader.next(query); first = false) {
+        if (!first) outputFile << "\n";
+        RestrictedRoutesResult result = excludeNodesOrSegments(map, ws, query.origin, query.destination, query.avoidNodes,
+                                                               query.avoidSegments, query.includeNode, query.algorithm);
+        outputRestrictedRouteResult(result, outputFile, query.origin, query.destination);
     }
 
-    RestrictedRoutesResult result = excludeNodesOrSegments(origin, destination, avoidNodes, avoidSegments, include);
-    outputRestrictedRouteResult(result, outputFile, origin, destination);
-
     inputFile.close();
     outputFile.close();
 }
 
 /**
  * @brief Handles user choice for fastest route input method.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void handleFastestRouteOption() {
+void handleFastestRouteOption(const LoadedMap& map, SearchWorkspace& ws) {
     int subChoice = 0;
     std::cout << "Fastest Route: Choose input method:\n";
     std::cout << "  1) Manual input (terminal)\n";
@@ -416,9 +273,9 @@ void handleFastestRouteOption() {
     std::cin >> subChoice;
 
     if (subChoice == 1) {
-        planFastestRouteMenu();
+        planFastestRouteMenu(map, ws);
     } else if (subChoice == 2) {
-        planFastestRouteBatch();
+        planFastestRouteBatch(map, ws);
     } else {
         std::cout << "Invalid sub-choice.\n";
     }
@@ -426,8 +283,11 @@ void handleFastestRouteOption() {
 
 /**
  * @brief Handles user choice for environmentally friendly route input method.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void handleEnvironmentallyFriendlyRouteOption() {
+void handleEnvironmentallyFriendlyRouteOption(const LoadedMap& map, SearchWorkspace& ws) {
     int subChoice = 0;
     std::cout << "Environmentally Friendly Route: Choose input method:\n";
     std::cout << "  1) Manual input (terminal)\n";
@@ -436,9 +296,9 @@ void handleEnvironmentallyFriendlyRouteOption() {
     std::cin >> subChoice;
 
     if (subChoice == 1) {
-        planEnvironmentallyFriendlyRouteMenu();
+        planEnvironmentallyFriendlyRouteMenu(map, ws);
     } else if (subChoice == 2) {
-        planEnvironmentallyFriendlyRouteBatch();
+        planEnvironmentallyFriendlyRouteBatch(map, ws);
     } else {
         std::cout << "Invalid sub-choice.\n";
     }
@@ -446,8 +306,11 @@ void handleEnvironmentallyFriendlyRouteOption() {
 
 /**
  * @brief Handles user choice for restricted route input method.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void handleRestrictedOption() {
+void handleRestrictedOption(const LoadedMap& map, SearchWorkspace& ws) {
     int subChoice = 0;
     std::cout << "Restricted Route: Choose input method:\n";
     std::cout << "  1) Manual input (terminal)\n";
@@ -456,9 +319,9 @@ void handleRestrictedOption() {
     std::cin >> subChoice;
 
     if (subChoice == 1) {
-        excludeNodesOrSegmentsMenu();
+        excludeNodesOrSegmentsMenu(map, ws);
     } else if (subChoice == 2) {
-        excludeNodesOrSegmentsBatch();
+        excludeNodesOrSegmentsBatch(map, ws);
     } else {
         std::cout << "Invalid sub-choice.\n";
     }
@@ -481,8 +344,11 @@ void showMainMenu() {
 
 /**
  * @brief Handles user selection from the main menu.
+ *
+ * @param map The loaded map, shared between queries.
+ * @param ws Search workspace reused across queries.
  */
-void handleMenuSelection() {
+void handleMenuSelection(const LoadedMap& map, SearchWorkspace& ws) {
     int choice = 0;
     while (choice != 4) {
         showMainMenu();
@@ -499,13 +365,13 @@ void handleMenuSelection() {
 
         switch (choice) {
             case 1:
-                handleFastestRouteOption();
+                handleFastestRouteOption(map, ws);
                 break;
             case 2:
-                handleRestrictedOption();
+                handleRestrictedOption(map, ws);
                 break;
             case 3:
-                handleEnvironmentallyFriendlyRouteOption();
+                handleEnvironmentallyFriendlyRouteOption(map, ws);
                 break;
             case 4:
                 std::cout << "Exiting the program...\n";